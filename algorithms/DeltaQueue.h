@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+////////////////////////////////////////////////////
+//
+// Live view of a running planner. The planner thread publishes every new
+// tree edge and every new path into a lock-free single-producer /
+// single-consumer ring; the render loop drains whatever arrived since the
+// last frame. Neither side ever waits for the other: when the ring is full
+// the producer drops the delta and counts it (the finished planner is
+// drawn from its own tree anyway), and the consumer only touches the
+// entries that are new.
+//
+////////////////////////////////////////////////////
+
+// Bounded SPSC ring. Capacity must be a power of two. Head and tail live on separate cache
+// lines, and each side keeps a private copy of the other's index so it only reads the shared
+// one when the ring looks full (producer) or empty (consumer).
+// Over-aligned: give it static storage or make it a member of such an object.
+template <class T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SpscQueue() : head(0), cachedTail(0), tail(0), cachedHead(0) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // producer only; false when full
+    bool push(const T& item) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead == Capacity) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead == Capacity) return false;
+        }
+        items[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only; false when empty
+    bool pop(T& item) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail) return false;
+        }
+        item = items[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only; hands every available item to f and releases them all at once
+    template <class F>
+    size_t drain(F f) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        cachedTail = tail.load(std::memory_order_acquire);
+        for (size_t i = h; i != cachedTail; ++i) f(items[i & (Capacity - 1)]);
+        head.store(cachedTail, std::memory_order_release);
+        return cachedTail - h;
+    }
+
+private:
+    alignas(64) std::atomic<size_t> head;      // written by the consumer
+    size_t cachedTail;
+    alignas(64) std::atomic<size_t> tail;      // written by the producer
+    size_t cachedHead;
+    alignas(64) T items[Capacity];
+};
+
+
+// One record of the live view, in the (x, y) projection
+struct TreeDelta {
+    enum Kind : uint8_t {
+        EDGE,           // new tree edge
+        PATH_CLEAR,     // a new path follows, forget the previous one
+        PATH_EDGE
+    };
+
+    uint8_t source;     // which planner, chosen by the caller
+    uint8_t kind;
+    float x0, y0, x1, y1;
+};
+
+typedef SpscQueue<TreeDelta, 1 << 16> DeltaQueue;
+
+
+// Producer side for one planner: turns the nodes inserted since the previous call into edges.
+// Planners sharing a queue must run on the same thread, one after the other.
+class TreePublisher {
+public:
+    TreePublisher(DeltaQueue& queue, uint8_t source) : queue(queue), source(source), published(0), dropped(0) {}
+
+    template <class P>
+    void publish(const P& planner) {
+        const auto& nodes = planner.index().all();
+        for (; published < nodes.size(); ++published) {
+            const auto* node = nodes[published];
+            if (node->parent) send(TreeDelta::EDGE, node->parent->position, node->position);
+        }
+    }
+
+    template <class State>
+    void publishPath(const std::vector<State>& path) {
+        TreeDelta clear = {source, TreeDelta::PATH_CLEAR, 0.0f, 0.0f, 0.0f, 0.0f};
+        if (!queue.push(clear)) ++dropped;
+        for (size_t i = 1; i < path.size(); ++i) send(TreeDelta::PATH_EDGE, path[i - 1], path[i]);
+    }
+
+    size_t getDropped() const { return dropped; }
+
+private:
+    template <class State>
+    void send(TreeDelta::Kind kind, const State& from, const State& to) {
+        TreeDelta delta = {source, kind, from[0], from[1], to[0], to[1]};
+        if (!queue.push(delta)) ++dropped;
+    }
+
+    DeltaQueue& queue;
+    uint8_t source;
+    size_t published;       // nodes of the planner's tree already sent
+    size_t dropped;
+};
@@ -0,0 +1,271 @@
+#include "GridPlanner.h"
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+const float SQRT2 = 1.41421356f;
+
+int sign(int value) {
+    return (value > 0) - (value < 0);
+}
+
+} // namespace
+
+void BitGrid::reset(int width, int height) {
+    this->width = width;
+    this->height = height;
+    stride = (static_cast<size_t>(width) + 2 + 63) / 64;
+    bits.assign(stride * (height + 2), 0);
+
+    block(-1, -1, width, -1);
+    block(-1, height, width, height);
+    block(-1, -1, -1, height);
+    block(width, -1, width, height);
+}
+
+void BitGrid::block(int x0, int y0, int x1, int y1) {
+    x0 = std::max(x0, -1);
+    y0 = std::max(y0, -1);
+    x1 = std::min(x1, width);
+    y1 = std::min(y1, height);
+    if (x0 > x1 || y0 > y1) return;
+
+    // whole words at a time: first and last word masked, the ones in between filled
+    const size_t first = static_cast<size_t>(x0 + 1), last = static_cast<size_t>(x1 + 1);
+    const size_t firstWord = first >> 6, lastWord = last >> 6;
+    const uint64_t firstMask = ~0ULL << (first & 63);
+    const uint64_t lastMask = ~0ULL >> (63 - (last & 63));
+
+    for (int y = y0; y <= y1; ++y) {
+        uint64_t* row = &bits[static_cast<size_t>(y + 1) * stride];
+        if (firstWord == lastWord) {
+            row[firstWord] |= firstMask & lastMask;
+            continue;
+        }
+        row[firstWord] |= firstMask;
+        for (size_t w = firstWord + 1; w < lastWord; ++w) row[w] = ~0ULL;
+        row[lastWord] |= lastMask;
+    }
+}
+
+
+GridPlanner::GridPlanner(sf::Vector2f start, sf::Vector2f goal, const std::vector<sf::RectangleShape>& obstacles, float resolution)
+    : start(toVec2(start)), goal(toVec2(goal)), resolution(resolution), columns(0), goalX(0), goalY(0),
+      searchId(0), pathLength(0), color(sf::Color(255, 140, 0)) {
+    const int width = static_cast<int>(std::ceil(800.0f / resolution));
+    const int height = static_cast<int>(std::ceil(600.0f / resolution));
+    grid.reset(width, height);
+    columns = width;
+
+    // a cell is blocked when an obstacle overlaps its interior
+    for (const ObstacleRect& r : toObstacleRects(obstacles)) {
+        grid.block(static_cast<int>(std::floor(r.minX / resolution)), static_cast<int>(std::floor(r.minY / resolution)),
+                   static_cast<int>(std::ceil(r.maxX / resolution)) - 1, static_cast<int>(std::ceil(r.maxY / resolution)) - 1);
+    }
+
+    const size_t cells = static_cast<size_t>(width) * height;
+    g.resize(cells);
+    parent.resize(cells);
+    seen.assign(cells, 0);
+    closed.assign(cells, 0);
+}
+
+Vec2 GridPlanner::cellCenter(int id) const {
+    return Vec2{(cellX(id) + 0.5f) * resolution, (cellY(id) + 0.5f) * resolution};
+}
+
+float GridPlanner::octile(int a, int b) const {
+    const int dx = std::abs(cellX(a) - cellX(b)), dy = std::abs(cellY(a) - cellY(b));
+    return std::max(dx, dy) + (SQRT2 - 1.0f) * std::min(dx, dy);
+}
+
+bool GridPlanner::run() {
+    if (!plan(start, goal)) {
+        std::cout << "final GridJPS: no path\n";
+        return false;
+    }
+    std::cout << "final GridJPS Expanded: " << getExpanded() << "\n";
+    std::cout << "final GridJPS Distance: " << pathLength << "\n";
+    return true;
+}
+
+// Straight scan from (x, y); stops at the goal or at a cell with a forced neighbour
+bool GridPlanner::jumpStraight(int x, int y, int dx, int dy, int& jx, int& jy) const {
+    for (;; x += dx, y += dy) {
+        if (grid.blocked(x, y)) return false;
+        if (x == goalX && y == goalY) break;
+
+        if (dx != 0) {
+            if ((grid.walkable(x, y - 1) && grid.blocked(x - dx, y - 1)) ||
+                (grid.walkable(x, y + 1) && grid.blocked(x - dx, y + 1))) break;
+        } else {
+            if ((grid.walkable(x - 1, y) && grid.blocked(x - 1, y - dy)) ||
+                (grid.walkable(x + 1, y) && grid.blocked(x + 1, y - dy))) break;
+        }
+    }
+    jx = x;
+    jy = y;
+    return true;
+}
+
+// Diagonal scan; a cell is a jump point when either straight scan from it finds one
+bool GridPlanner::jumpDiagonal(int x, int y, int dx, int dy, int& jx, int& jy) const {
+    int ignoredX, ignoredY;
+    for (;; x += dx, y += dy) {
+        if (grid.blocked(x, y)) return false;
+        if (x == goalX && y == goalY) break;
+        if (jumpStraight(x + dx, y, dx, 0, ignoredX, ignoredY) || jumpStraight(x, y + dy, 0, dy, ignoredX, ignoredY)) break;
+
+        // no corner cutting: both side cells must be free to keep going
+        if (grid.blocked(x + dx, y) || grid.blocked(x, y + dy)) return false;
+    }
+    jx = x;
+    jy = y;
+    return true;
+}
+
+void GridPlanner::addSuccessor(int from, int x, int y, int dx, int dy) {
+    int jx, jy;
+    const bool found = dx != 0 && dy != 0 ? jumpDiagonal(x, y, dx, dy, jx, jy) : jumpStraight(x, y, dx, dy, jx, jy);
+    if (!found) return;
+
+    const int next = cellId(jx, jy);
+    if (closed[next] == searchId) return;
+
+    const float cost = g[from] + octile(from, next);
+    if (seen[next] == searchId && cost >= g[next]) return;
+
+    seen[next] = searchId;
+    g[next] = cost;
+    parent[next] = from;
+    OpenItem item = {cost + octile(next, cellId(goalX, goalY)), next};
+    open.push_back(item);
+    std::push_heap(open.begin(), open.end(), std::greater<OpenItem>());
+}
+
+bool GridPlanner::plan(const Vec2& startPoint, const Vec2& goalPoint) {
+    start = startPoint;
+    goal = goalPoint;
+    path.clear();
+    pathLength = 0;
+    expandedCells.clear();
+    open.clear();
+
+    const int startX = static_cast<int>(std::floor(start[0] / resolution));
+    const int startY = static_cast<int>(std::floor(start[1] / resolution));
+    goalX = static_cast<int>(std::floor(goal[0] / resolution));
+    goalY = static_cast<int>(std::floor(goal[1] / resolution));
+    if (startX < 0 || startY < 0 || startX >= grid.getWidth() || startY >= grid.getHeight() ||
+        goalX < 0 || goalY < 0 || goalX >= grid.getWidth() || goalY >= grid.getHeight() ||
+        grid.blocked(startX, startY) || grid.blocked(goalX, goalY)) {
+        return false;
+    }
+
+    if (++searchId == 0) {
+        // stamps wrapped around: forget every old search once
+        std::fill(seen.begin(), seen.end(), 0);
+        std::fill(closed.begin(), closed.end(), 0);
+        searchId = 1;
+    }
+
+    const int startCell = cellId(startX, startY), goalCell = cellId(goalX, goalY);
+    seen[startCell] = searchId;
+    g[startCell] = 0.0f;
+    parent[startCell] = -1;
+    OpenItem first = {octile(startCell, goalCell), startCell};
+    open.push_back(first);
+
+    bool found = false;
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), std::greater<OpenItem>());
+        const int current = open.back().cell;
+        open.pop_back();
+        if (closed[current] == searchId) continue;
+        closed[current] = searchId;
+        expandedCells.push_back(current);
+
+        if (current == goalCell) {
+            found = true;
+            break;
+        }
+
+        const int x = cellX(current), y = cellY(current);
+        if (parent[current] < 0) {
+            // the start expands in every direction it can move
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if (dx == 0 && dy == 0) continue;
+                    if (dx != 0 && dy != 0 && (grid.blocked(x + dx, y) || grid.blocked(x, y + dy))) continue;
+                    addSuccessor(current, x + dx, y + dy, dx, dy);
+                }
+            }
+            continue;
+        }
+
+        // pruned neighbours for the direction we arrived from
+        const int dx = sign(x - cellX(parent[current])), dy = sign(y - cellY(parent[current]));
+        if (dx != 0 && dy != 0) {
+            const bool vertical = grid.walkable(x, y + dy), horizontal = grid.walkable(x + dx, y);
+            if (vertical) addSuccessor(current, x, y + dy, 0, dy);
+            if (horizontal) addSuccessor(current, x + dx, y, dx, 0);
+            if (vertical && horizontal) addSuccessor(current, x + dx, y + dy, dx, dy);
+        } else if (dx != 0) {
+            const bool next = grid.walkable(x + dx, y), up = grid.walkable(x, y - 1), down = grid.walkable(x, y + 1);
+            if (next) {
+                addSuccessor(current, x + dx, y, dx, 0);
+                if (up) addSuccessor(current, x + dx, y - 1, dx, -1);
+                if (down) addSuccessor(current, x + dx, y + 1, dx, 1);
+            }
+            if (up) addSuccessor(current, x, y - 1, 0, -1);
+            if (down) addSuccessor(current, x, y + 1, 0, 1);
+        } else {
+            const bool next = grid.walkable(x, y + dy), left = grid.walkable(x - 1, y), right = grid.walkable(x + 1, y);
+            if (next) {
+                addSuccessor(current, x, y + dy, 0, dy);
+                if (left) addSuccessor(current, x - 1, y + dy, -1, dy);
+                if (right) addSuccessor(current, x + 1, y + dy, 1, dy);
+            }
+            if (left) addSuccessor(current, x - 1, y, -1, 0);
+            if (right) addSuccessor(current, x + 1, y, 1, 0);
+        }
+    }
+    if (!found) return false;
+
+    // jump points from goal back to start, between the exact end points
+    path.push_back(goal);
+    for (int cell = goalCell; cell != -1; cell = parent[cell]) {
+        path.push_back(cellCenter(cell));
+    }
+    path.push_back(start);
+    std::reverse(path.begin(), path.end());
+
+    for (size_t i = 1; i < path.size(); ++i) {
+        pathLength += std::sqrt(squaredDistance(path[i - 1], path[i]));
+    }
+    return true;
+}
+
+void GridPlanner::drawPath(sf::RenderWindow& window) const {
+    for (size_t i = 1; i < path.size(); ++i) {
+        sf::Vertex line[] = {
+            sf::Vertex(toVector2f(path[i - 1]), color),
+            sf::Vertex(toVector2f(path[i]), color)
+        };
+        window.draw(line, 2, sf::Lines);
+    }
+}
+
+void GridPlanner::drawTree(sf::RenderWindow& window) const {
+    for (int cell : expandedCells) {
+        if (parent[cell] < 0) continue;
+        sf::Vertex line[] = {
+            sf::Vertex(toVector2f(cellCenter(cell)), sf::Color(100,100,100,80)),
+            sf::Vertex(toVector2f(cellCenter(parent[cell])), sf::Color(100,100,100,80))
+        };
+        window.draw(line, 2, sf::Lines);
+    }
+}
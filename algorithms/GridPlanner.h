@@ -0,0 +1,101 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstdint>
+#include "Obstacles.h"
+
+////////////////////////////////////////////////////
+//
+// Deterministic baseline: the obstacles are rasterized into an occupancy
+// grid and searched with A* + Jump Point Search (8-connected, diagonal moves
+// only when both side cells are free, so paths never cut obstacle corners).
+//
+// The grid stores one bit per cell in 64-bit words with a one-cell blocked
+// border, so jumps never bounds-check. The open list is a binary heap kept
+// between searches, and per-cell state is invalidated by a search stamp
+// instead of being cleared; repeated searches on one planner do not allocate.
+//
+////////////////////////////////////////////////////
+class BitGrid {
+public:
+    BitGrid() : width(0), height(0), stride(0) {}
+
+    // width x height free cells inside a blocked border
+    void reset(int width, int height);
+
+    // marks the inclusive cell range, clipped to the grid
+    void block(int x0, int y0, int x1, int y1);
+
+    // x in [-1, width], y in [-1, height]; the border reads as blocked
+    bool blocked(int x, int y) const {
+        const size_t bit = static_cast<size_t>(x + 1);
+        return (bits[static_cast<size_t>(y + 1) * stride + (bit >> 6)] >> (bit & 63)) & 1;
+    }
+    bool walkable(int x, int y) const { return !blocked(x, y); }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+private:
+    int width, height;
+    size_t stride;                  // words per row, border included
+    std::vector<uint64_t> bits;
+};
+
+
+class GridPlanner {
+public:
+    // resolution is the cell size in pixels, over the same 800x600 world as the RRT planners
+    GridPlanner(sf::Vector2f start, sf::Vector2f goal, const std::vector<sf::RectangleShape>& obstacles, float resolution = 5.0f);
+
+    bool run();
+
+    // searches again on the same grid, reusing every buffer
+    bool plan(const Vec2& start, const Vec2& goal);
+
+    float getPathDistance() const { return pathLength; }
+    std::vector<Vec2> getPath() const { return path; }
+    int getExpanded() const { return static_cast<int>(expandedCells.size()); }
+
+    void drawPath(sf::RenderWindow& window) const;
+    void drawTree(sf::RenderWindow& window) const;    // jump point links of the last search
+
+private:
+    struct OpenItem {
+        float f;
+        int cell;
+        bool operator>(const OpenItem& other) const { return f > other.f; }
+    };
+
+    int cellId(int x, int y) const { return y * columns + x; }
+    int cellX(int id) const { return id % columns; }
+    int cellY(int id) const { return id / columns; }
+    Vec2 cellCenter(int id) const;
+    float octile(int a, int b) const;
+
+    bool jumpStraight(int x, int y, int dx, int dy, int& jx, int& jy) const;
+    bool jumpDiagonal(int x, int y, int dx, int dy, int& jx, int& jy) const;
+    void addSuccessor(int from, int x, int y, int dx, int dy);
+
+    Vec2 start;
+    Vec2 goal;
+    float resolution;
+    BitGrid grid;
+
+    int columns;                    // grid width, used for cell ids
+    int goalX, goalY;
+
+    // search state reused between plans
+    uint32_t searchId;
+    std::vector<float> g;
+    std::vector<int> parent;
+    std::vector<uint32_t> seen;     // g/parent are valid when seen == searchId
+    std::vector<uint32_t> closed;
+    std::vector<OpenItem> open;
+    std::vector<int> expandedCells;
+
+    std::vector<Vec2> path;
+    float pathLength;
+    sf::Color color;
+};
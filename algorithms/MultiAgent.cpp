@@ -0,0 +1,247 @@
+#include "MultiAgent.h"
+
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+
+namespace {
+
+// position at time t of the linear motion a -> b
+Vec2 positionAt(const SpaceTime& a, const SpaceTime& b, float t) {
+    const float dt = b[2] - a[2];
+    if (dt <= 0.0f) return Vec2{a[0], a[1]};
+    const float u = (t - a[2]) / dt;
+    return Vec2{a[0] + (b[0] - a[0]) * u, a[1] + (b[1] - a[1]) * u};
+}
+
+struct Area {
+    float minX, minY, maxX, maxY;
+};
+
+Area taskArea(const AgentTask& task, float margin) {
+    Area area = {std::min(task.start[0], task.goal[0]) - margin, std::min(task.start[1], task.goal[1]) - margin,
+                 std::max(task.start[0], task.goal[0]) + margin, std::max(task.start[1], task.goal[1]) + margin};
+    return area;
+}
+
+bool overlaps(const Area& a, const Area& b) {
+    return a.minX < b.maxX && b.minX < a.maxX && a.minY < b.maxY && b.minY < a.maxY;
+}
+
+const sf::Color AGENT_COLORS[] = {
+    sf::Color::Yellow, sf::Color::Cyan, sf::Color::Magenta, sf::Color::Green,
+    sf::Color(255, 140, 0), sf::Color(150, 100, 255), sf::Color::White, sf::Color(255, 100, 100)
+};
+
+} // namespace
+
+ReservationTable::ReservationTable(float agentRadius, float cellSize)
+    : radius(agentRadius), cellSize(cellSize) {}
+
+uint64_t ReservationTable::key(int cx, int cy, int bucket) {
+    // 21 bits per axis, offset so negative cells hash too
+    const uint64_t mask = (1ULL << 21) - 1;
+    return ((static_cast<uint64_t>(cx + (1 << 20)) & mask) << 42) |
+           ((static_cast<uint64_t>(cy + (1 << 20)) & mask) << 21) |
+           (static_cast<uint64_t>(bucket + (1 << 20)) & mask);
+}
+
+void ReservationTable::reserve(int agent, const std::vector<SpaceTime>& path) {
+    for (size_t i = 1; i < path.size(); ++i) {
+        const SpaceTime& a = path[i - 1];
+        const SpaceTime& b = path[i];
+        Motion motion = {a, b, agent};
+        const uint32_t id = static_cast<uint32_t>(motions.size());
+        motions.push_back(motion);
+
+        // stored under its plain bounding box, queries inflate theirs by the separation
+        const int c0 = cell(std::min(a[0], b[0])), c1 = cell(std::max(a[0], b[0]));
+        const int r0 = cell(std::min(a[1], b[1])), r1 = cell(std::max(a[1], b[1]));
+        const int t0 = cell(a[2]), t1 = cell(b[2]);
+        for (int t = t0; t <= t1; ++t) {
+            for (int r = r0; r <= r1; ++r) {
+                for (int c = c0; c <= c1; ++c) {
+                    buckets[key(c, r, t)].push_back(id);
+                }
+            }
+        }
+    }
+}
+
+bool ReservationTable::conflict(const Motion& motion, const SpaceTime& a, const SpaceTime& b) const {
+    const float lo = std::max(motion.from[2], a[2]), hi = std::min(motion.to[2], b[2]);
+    if (lo > hi) return false;
+
+    // relative motion is linear over [lo, hi]: closest approach is the distance from the origin to a segment
+    const Vec2 r0 = positionAt(a, b, lo) - positionAt(motion.from, motion.to, lo);
+    const Vec2 r1 = positionAt(a, b, hi) - positionAt(motion.from, motion.to, hi);
+    const Vec2 d = r1 - r0;
+    const float length2 = squaredNorm(d);
+    float u = 0.0f;
+    if (length2 > 0.0f) {
+        u = std::min(std::max(-(r0[0] * d[0] + r0[1] * d[1]) / length2, 0.0f), 1.0f);
+    }
+    const float separation = 2.0f * radius;
+    return squaredNorm(r0 + d * u) < separation * separation;
+}
+
+bool ReservationTable::segmentFree(const SpaceTime& a, const SpaceTime& b) const {
+    if (motions.empty()) return true;
+
+    const float separation = 2.0f * radius;
+    const int c0 = cell(std::min(a[0], b[0]) - separation), c1 = cell(std::max(a[0], b[0]) + separation);
+    const int r0 = cell(std::min(a[1], b[1]) - separation), r1 = cell(std::max(a[1], b[1]) + separation);
+    const int t0 = cell(std::min(a[2], b[2])), t1 = cell(std::max(a[2], b[2]));
+
+    // a motion spanning several buckets is tested once per bucket; cheaper than deduplicating
+    for (int t = t0; t <= t1; ++t) {
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                auto bucket = buckets.find(key(c, r, t));
+                if (bucket == buckets.end()) continue;
+                for (uint32_t id : bucket->second) {
+                    if (conflict(motions[id], a, b)) return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool ReservationTable::pathFree(const std::vector<SpaceTime>& path) const {
+    for (size_t i = 1; i < path.size(); ++i) {
+        if (!segmentFree(path[i - 1], path[i])) return false;
+    }
+    return true;
+}
+
+void ReservationTable::clear() {
+    motions.clear();
+    buckets.clear();
+}
+
+
+FleetPlanner::FleetPlanner(const std::vector<sf::RectangleShape>& obstacles, float agentRadius, float stepSize)
+    : statics(obstacles, std::vector<sf::ConvexShape>(), Footprint::disc(agentRadius)), radius(agentRadius), stepSize(stepSize),
+      table(agentRadius, 2.0f * stepSize + 4.0f * agentRadius) {
+    setBounds(Vec2{0, 0}, Vec2{800, 600});
+}
+
+FleetPlanner::FleetPlanner(const ObstacleRect* rects, size_t count, float agentRadius, float stepSize)
+    : statics(rects, count, Footprint::disc(agentRadius)), radius(agentRadius), stepSize(stepSize),
+      table(agentRadius, 2.0f * stepSize + 4.0f * agentRadius) {
+    setBounds(Vec2{0, 0}, Vec2{800, 600});
+}
+
+void FleetPlanner::setBounds(const Vec2& lowerBound, const Vec2& upperBound) {
+    lower = lowerBound;
+    upper = upperBound;
+    horizon = 2.0f * std::sqrt(squaredDistance(lower, upper));
+}
+
+void FleetPlanner::setHorizon(float value) {
+    horizon = value;
+}
+
+AgentPlan FleetPlanner::planAgent(const AgentTask& task, int maxIterations) const {
+    AgentPlan result;
+    result.found = false;
+    result.arrival = 0.0f;
+    result.iterations = 0;
+
+    const SpaceTime start{task.start[0], task.start[1], 0.0f};
+    const SpaceTime goal{task.goal[0], task.goal[1], horizon};
+    SpaceTimeCollision checker(statics, table);
+    // blocked start, or the goal is taken for good by a parked agent
+    if (!checker.edgeFree(start, start) || !checker.edgeFree(goal, goal)) return result;
+
+    SpaceTimeRRT planner("Agent", sf::Color::White, start, goal, checker, stepSize);
+    planner.setBounds(SpaceTime{lower[0], lower[1], 0.0f}, SpaceTime{upper[0], upper[1], horizon});
+    planner.setVerbose(false);
+
+    result.found = planner.run(maxIterations);
+    result.iterations = result.found ? planner.getIterations() : maxIterations;
+    if (!result.found) return result;
+
+    result.path = planner.getPath();
+    for (const SpaceTime& s : result.path) {
+        if (s[0] == goal[0] && s[1] == goal[1]) {
+            result.arrival = s[2];
+            break;
+        }
+    }
+    return result;
+}
+
+size_t FleetPlanner::waveEnd(const std::vector<AgentTask>& agents, size_t first, size_t maxSize) const {
+    // far enough apart that their trees rarely meet in the first steps
+    const float margin = 4.0f * stepSize + 2.0f * radius;
+    std::vector<Area> taken;
+    size_t last = first;
+    while (last < agents.size() && last - first < maxSize) {
+        const Area area = taskArea(agents[last], margin);
+        for (const Area& other : taken) {
+            if (overlaps(area, other)) return last;
+        }
+        taken.push_back(area);
+        ++last;
+    }
+    return last;
+}
+
+int FleetPlanner::plan(const std::vector<AgentTask>& agents, int maxIterations, int threads) {
+    if (threads <= 0) threads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+
+    table.clear();
+    plans.assign(agents.size(), AgentPlan());
+
+    int found = 0;
+    const size_t maxWave = static_cast<size_t>(threads) * 4;
+    for (size_t first = 0; first < agents.size(); ) {
+        const size_t last = waveEnd(agents, first, maxWave);
+
+        // the table is only read while the wave is planned
+        std::atomic<size_t> next(first);
+        auto work = [&]() {
+            for (size_t i = next++; i < last; i = next++) {
+                plans[i] = planAgent(agents[i], maxIterations);
+            }
+        };
+        const int workers = static_cast<int>(std::min(static_cast<size_t>(threads), last - first));
+        if (workers <= 1) {
+            work();
+        } else {
+            std::vector<std::thread> pool;
+            for (int w = 0; w < workers; ++w) pool.push_back(std::thread(work));
+            for (std::thread& worker : pool) worker.join();
+        }
+
+        // commit in priority order; a path crossing a higher-priority agent of the same wave is redone
+        for (size_t i = first; i < last; ++i) {
+            if (plans[i].found && !table.pathFree(plans[i].path)) {
+                plans[i] = planAgent(agents[i], maxIterations);
+            }
+            if (!plans[i].found) continue;
+            table.reserve(static_cast<int>(i), plans[i].path);
+            ++found;
+        }
+        first = last;
+    }
+    return found;
+}
+
+void FleetPlanner::drawPaths(sf::RenderWindow& window) const {
+    const size_t colorCount = sizeof(AGENT_COLORS) / sizeof(AGENT_COLORS[0]);
+    for (size_t a = 0; a < plans.size(); ++a) {
+        const std::vector<SpaceTime>& path = plans[a].path;
+        const sf::Color& color = AGENT_COLORS[a % colorCount];
+        for (size_t i = 1; i < path.size(); ++i) {
+            sf::Vertex line[] = {
+                sf::Vertex(toVector2f(path[i - 1]), color),
+                sf::Vertex(toVector2f(path[i]), color)
+            };
+            window.draw(line, 2, sf::Lines);
+        }
+    }
+}
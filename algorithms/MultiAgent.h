@@ -0,0 +1,247 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "Planner.h"
+
+////////////////////////////////////////////////////
+//
+// Prioritized planning for a fleet of disc robots sharing one map.
+//
+// Agents are planned one after the other in priority order (the order of the
+// task list) in space-time: a state is (x, y, t) and an agent moves at most one
+// unit of distance per unit of time, waiting in place included. Every path that
+// is found is written to a reservation table, and lower-priority agents treat
+// it as a moving obstacle. Agents park at their goal until the horizon, so the
+// parked robot is reserved too.
+//
+// The table is a spatial hash over (x, y, time bucket), so a conflict check
+// only visits the motions near the edge being tested and the cost per agent does
+// not grow with the fleet. Consecutive agents whose start/goal areas are far
+// apart are planned in parallel against the table of the earlier agents, then
+// committed in order; one that does conflict with an agent of its own wave is
+// simply planned again.
+//
+// As usual for prioritized planning, an agent does not know about lower-priority
+// ones, so it may drive over their start position. The static obstacles are
+// inflated once by the agent radius and shared by every agent.
+//
+////////////////////////////////////////////////////
+
+typedef VecN<3> SpaceTime;     // (x, y, t)
+
+// Euclidean distance in (x, y, t), but only forward in time and no faster than speed 1;
+// the other pairs are infinitely far apart
+struct SpaceTimeMetric {
+    typedef SpaceTime State;
+
+    // b can be reached from a
+    static bool causal(const State& a, const State& b) {
+        const float dx = b[0] - a[0], dy = b[1] - a[1], dt = b[2] - a[2];
+        return dt >= 0.0f && dt * dt * (1.0f + 1e-4f) + 1e-6f >= dx * dx + dy * dy;
+    }
+
+    static float distance2(const State& a, const State& b) {
+        return causal(a, b) ? squaredDistance(a, b) : std::numeric_limits<float>::max();
+    }
+
+    static float distance(const State& a, const State& b) {
+        return std::sqrt(distance2(a, b));
+    }
+
+    static State direction(const State& a, const State& b) {
+        State d = b - a;
+        return d / std::sqrt(squaredNorm(d));
+    }
+
+    // towards's time is pushed back to the earliest one reachable from `from`,
+    // then at most stepSize is travelled along the (now causal) segment
+    static State steer(const State& from, const State& towards, float stepSize) {
+        State target = towards;
+        const float dx = towards[0] - from[0], dy = towards[1] - from[1];
+        target[2] = std::max(towards[2], from[2] + std::sqrt(dx * dx + dy * dy));
+
+        const float length2 = squaredDistance(from, target);
+        if (length2 <= stepSize * stepSize) return target;
+        return from + (target - from) * (stepSize / std::sqrt(length2));
+    }
+
+    // Spatially closest stored state. Picking the closest one in (x, y, t) that can still reach
+    // the query would keep growing the tree next to the root: the frontier states were reached
+    // late and are rarely in the past cone of a sample. The sample time only makes steer wait.
+    static size_t nearest(const float* const coords[3], size_t count, const State& point) {
+        size_t best = 0;
+        float bestDist = std::numeric_limits<float>::max();
+        for (size_t i = 0; i < count; ++i) {
+            const float dx = point[0] - coords[0][i], dy = point[1] - coords[1][i];
+            const float spatial = dx * dx + dy * dy;
+            if (spatial < bestDist) {
+                bestDist = spatial;
+                best = i;
+            }
+        }
+        return best;
+    }
+};
+
+
+// Space-time paths of the agents planned so far. Agents are discs of the same radius
+// moving linearly between consecutive path states.
+class ReservationTable {
+public:
+    // cellSize is the spatial and temporal size of a hash bucket
+    ReservationTable(float agentRadius, float cellSize);
+
+    // path must be ordered in time
+    void reserve(int agent, const std::vector<SpaceTime>& path);
+
+    // true when a disc moving from a to b never comes closer than two radii to a reserved agent
+    bool segmentFree(const SpaceTime& a, const SpaceTime& b) const;
+    bool pathFree(const std::vector<SpaceTime>& path) const;
+
+    void clear();
+    size_t size() const { return motions.size(); }
+
+private:
+    struct Motion {
+        SpaceTime from, to;
+        int agent;
+    };
+
+    bool conflict(const Motion& motion, const SpaceTime& a, const SpaceTime& b) const;
+    int cell(float value) const { return static_cast<int>(std::floor(value / cellSize)); }
+    static uint64_t key(int cx, int cy, int bucket);
+
+    float radius;
+    float cellSize;
+    std::vector<Motion> motions;
+    std::unordered_map<uint64_t, std::vector<uint32_t> > buckets;    // motion ids per (x, y, t) cell
+};
+
+
+// Static obstacles on the (x, y) projection plus the agents already in the table
+class SpaceTimeCollision {
+public:
+    SpaceTimeCollision(const AABBCollision& statics, const ReservationTable& table)
+        : statics(statics), table(&table) {}
+
+    bool edgeFree(const SpaceTime& a, const SpaceTime& b) const {
+        return statics.edgeFree(Vec2{a[0], a[1]}, Vec2{b[0], b[1]}) && table->segmentFree(a, b);
+    }
+
+    void edgeFreeBatch(const std::vector<SpaceTime>& from, const std::vector<SpaceTime>& to, std::vector<char>& isFree) const {
+        isFree.resize(from.size());
+        for (size_t i = 0; i < from.size(); ++i) {
+            isFree[i] = edgeFree(from[i], to[i]);
+        }
+    }
+
+private:
+    AABBCollision statics;
+    const ReservationTable* table;
+};
+
+// (x, y) uniform in the bounds, t uniform between the earliest arrival from the start and half
+// as long again (agents rarely need long waits); Percent% of the samples are the goal at time 0,
+// i.e. "head for the goal at full speed"
+template <int Percent = 10>
+struct SpaceTimeSampler : SamplerBase {
+    template <class P>
+    SpaceTime sample(const P& planner) {
+        const SpaceTime& start = planner.getStart();
+        SpaceTime s;
+        if (randint(0, 99) < Percent) {
+            s = planner.getGoal();
+            s[2] = 0.0f;
+            return s;
+        }
+        s[0] = randfloat(planner.getLower()[0], planner.getUpper()[0]);
+        s[1] = randfloat(planner.getLower()[1], planner.getUpper()[1]);
+        const float dx = s[0] - start[0], dy = s[1] - start[1];
+        const float earliest = std::min(start[2] + std::sqrt(dx * dx + dy * dy), planner.getUpper()[2]);
+        s[2] = randfloat(earliest, std::min(earliest * 1.5f + 4.0f * planner.getStepSize(), planner.getUpper()[2]));
+        return s;
+    }
+};
+
+// The planner's goal is (goal x, goal y, horizon). A node is done when the goal is within a
+// step and both the move onto it at full speed and the wait there until the horizon are free.
+struct SpaceTimeExtender : StepExtender {
+    template <class P>
+    bool reached(const P& planner, const typename P::NodeType* node) const {
+        const SpaceTime arrival = arrivalFrom(node->position, planner.getGoal());
+        return arrival[2] - node->position[2] < planner.getStepSize() &&
+               arrival[2] <= planner.getGoal()[2] &&
+               planner.collision().edgeFree(node->position, arrival) &&
+               planner.collision().edgeFree(arrival, planner.getGoal());
+    }
+
+    template <class P>
+    void appendPath(const P& planner, std::vector<SpaceTime>& path) const {
+        const SpaceTime arrival = arrivalFrom(path.back(), planner.getGoal());
+        if (arrival != path.back()) path.push_back(arrival);
+    }
+
+    static SpaceTime arrivalFrom(const SpaceTime& s, const SpaceTime& goal) {
+        const float dx = goal[0] - s[0], dy = goal[1] - s[1];
+        return SpaceTime{goal[0], goal[1], s[2] + std::sqrt(dx * dx + dy * dy)};
+    }
+};
+
+typedef Planner<SpaceTimeSampler<>, LinearIndex<SpaceTimeMetric>, SpaceTimeCollision, SpaceTimeMetric, SpaceTimeExtender> SpaceTimeRRT;
+
+
+struct AgentTask {
+    Vec2 start;
+    Vec2 goal;
+};
+
+struct AgentPlan {
+    bool found;
+    float arrival;                  // time the goal is reached, the agent then waits there
+    int iterations;
+    std::vector<SpaceTime> path;    // start at t = 0 ... goal at the horizon
+};
+
+class FleetPlanner {
+public:
+    FleetPlanner(const std::vector<sf::RectangleShape>& obstacles, float agentRadius = 8.0f, float stepSize = 10.0f);
+
+    // the rects are copied, inflated by the agent radius
+    FleetPlanner(const ObstacleRect* rects, size_t count, float agentRadius = 8.0f, float stepSize = 10.0f);
+
+    // defaults to the 800x600 window
+    void setBounds(const Vec2& lower, const Vec2& upper);
+
+    // every agent reaches its goal and is parked there by this time; defaults to twice the bounds diagonal
+    void setHorizon(float horizon);
+
+    // Plans the agents in the order given (highest priority first) with up to `threads` planners
+    // at once, 0 meaning one per core. Returns how many agents got a path; the others are left
+    // out of the table.
+    int plan(const std::vector<AgentTask>& agents, int maxIterations = 20000, int threads = 0);
+
+    const std::vector<AgentPlan>& getPlans() const { return plans; }
+    const ReservationTable& reservations() const { return table; }
+
+    // (x, y) projection of every path, one colour per agent
+    void drawPaths(sf::RenderWindow& window) const;
+
+private:
+    // one agent against the table as it is now
+    AgentPlan planAgent(const AgentTask& task, int maxIterations) const;
+
+    // agents [first, last) whose start/goal areas do not overlap can be planned together
+    size_t waveEnd(const std::vector<AgentTask>& agents, size_t first, size_t maxSize) const;
+
+    AABBCollision statics;      // shared by every agent's planner
+    float radius;
+    float stepSize;
+    Vec2 lower, upper;
+    float horizon;
+
+    ReservationTable table;
+    std::vector<AgentPlan> plans;
+};
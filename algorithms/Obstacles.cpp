@@ -0,0 +1,316 @@
+#include "Obstacles.h"
+
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// below this many obstacles a linear scan beats the grid
+const size_t LINEAR_SCAN_LIMIT = 32;
+const int MAX_CELLS_PER_AXIS = 4096;
+
+// overlaps shorter than this along the segment count as grazing a corner
+const float GRAZE_EPSILON = 1e-4f;
+
+// sides of the polygon standing in for a disc footprint
+const int DISC_SIDES = 8;
+
+// Liang-Barsky clip of the segment against the open rectangle
+bool crossesInterior(const ObstacleRect& o, float x1, float y1, float x2, float y2) {
+    const float dx = x2 - x1, dy = y2 - y1;
+    float t0 = 0.0f, t1 = 1.0f;
+
+    if (dx == 0.0f) {
+        if (x1 <= o.minX || x1 >= o.maxX) return false;
+    } else {
+        float ta = (o.minX - x1) / dx, tb = (o.maxX - x1) / dx;
+        if (ta > tb) std::swap(ta, tb);
+        t0 = std::max(t0, ta);
+        t1 = std::min(t1, tb);
+    }
+
+    if (dy == 0.0f) {
+        if (y1 <= o.minY || y1 >= o.maxY) return false;
+    } else {
+        float ta = (o.minY - y1) / dy, tb = (o.maxY - y1) / dy;
+        if (ta > tb) std::swap(ta, tb);
+        t0 = std::max(t0, ta);
+        t1 = std::min(t1, tb);
+    }
+
+    return (t1 - t0) * std::sqrt(dx * dx + dy * dy) > GRAZE_EPSILON;
+}
+
+float project(const Vec2& axis, const Vec2& p) {
+    return axis[0] * p[0] + axis[1] * p[1];
+}
+
+// > 0 when o -> a -> b turns counter-clockwise (y up)
+float cross(const Vec2& o, const Vec2& a, const Vec2& b) {
+    return (a[0] - o[0]) * (b[1] - o[1]) - (a[1] - o[1]) * (b[0] - o[0]);
+}
+
+bool isAxisAligned(const sf::Transformable& shape) {
+    const float rest = std::fmod(shape.getRotation(), 90.0f);
+    return rest < 1e-3f || rest > 90.0f - 1e-3f;
+}
+
+} // namespace
+
+std::vector<ObstacleRect> toObstacleRects(const std::vector<sf::RectangleShape>& obstacles) {
+    std::vector<ObstacleRect> rects;
+    rects.reserve(obstacles.size());
+    for (auto& obstacle : obstacles) {
+        sf::FloatRect b = obstacle.getGlobalBounds();
+        ObstacleRect r;
+        r.minX = std::min(b.left, b.left + b.width);
+        r.maxX = std::max(b.left, b.left + b.width);
+        r.minY = std::min(b.top, b.top + b.height);
+        r.maxY = std::max(b.top, b.top + b.height);
+        rects.push_back(r);
+    }
+    return rects;
+}
+
+std::vector<Vec2> worldCorners(const sf::Shape& shape) {
+    const sf::Transform& transform = shape.getTransform();
+    std::vector<Vec2> corners;
+    corners.reserve(shape.getPointCount());
+    for (size_t i = 0; i < shape.getPointCount(); ++i) {
+        corners.push_back(toVec2(transform.transformPoint(shape.getPoint(i))));
+    }
+    return corners;
+}
+
+std::vector<Vec2> convexHull(std::vector<Vec2> points) {
+    std::sort(points.begin(), points.end(), [](const Vec2& a, const Vec2& b) {
+        return a[0] < b[0] || (a[0] == b[0] && a[1] < b[1]);
+    });
+    if (points.size() < 3) return points;
+
+    // monotone chain: lower hull left to right, then upper hull back
+    std::vector<Vec2> hull(2 * points.size());
+    size_t k = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0.0f) --k;
+        hull[k++] = points[i];
+    }
+    for (size_t i = points.size() - 1, lower = k + 1; i-- > 0; ) {
+        while (k >= lower && cross(hull[k - 2], hull[k - 1], points[i]) <= 0.0f) --k;
+        hull[k++] = points[i];
+    }
+    hull.resize(k - 1);
+    return hull;
+}
+
+void splitObstacles(const std::vector<sf::RectangleShape>& obstacles, const std::vector<sf::ConvexShape>& shapes,
+                    std::vector<ObstacleRect>& rects, std::vector<std::vector<Vec2> >& polygons) {
+    std::vector<sf::RectangleShape> aligned;
+    for (auto& obstacle : obstacles) {
+        if (isAxisAligned(obstacle)) aligned.push_back(obstacle);
+        else polygons.push_back(worldCorners(obstacle));
+    }
+    rects = toObstacleRects(aligned);
+    for (auto& shape : shapes) {
+        polygons.push_back(worldCorners(shape));
+    }
+}
+
+std::vector<Vec2> Footprint::outline() const {
+    std::vector<Vec2> corners;
+    if (radius > 0.0f) {
+        // the sides touch the disc, so the polygon contains it
+        const float pi = 3.14159265f;
+        const float reach = radius / std::cos(pi / DISC_SIDES);
+        for (int i = 0; i < DISC_SIDES; ++i) {
+            const float angle = 2.0f * pi * (i + 0.5f) / DISC_SIDES;
+            corners.push_back(Vec2{reach * std::cos(angle), reach * std::sin(angle)});
+        }
+        return corners;
+    }
+    corners.push_back(Vec2{-halfWidth, -halfHeight});
+    corners.push_back(Vec2{halfWidth, -halfHeight});
+    corners.push_back(Vec2{halfWidth, halfHeight});
+    corners.push_back(Vec2{-halfWidth, halfHeight});
+    return corners;
+}
+
+void inflateObstacles(const Footprint& footprint, std::vector<ObstacleRect>& rects,
+                      std::vector<std::vector<Vec2> >& polygons) {
+    if (footprint.isPoint()) return;
+
+    for (ObstacleRect& r : rects) {
+        r.minX -= footprint.halfWidth;
+        r.maxX += footprint.halfWidth;
+        r.minY -= footprint.halfHeight;
+        r.maxY += footprint.halfHeight;
+    }
+
+    // the Minkowski sum of two convex polygons is the hull of the pairwise vertex sums
+    const std::vector<Vec2> outline = footprint.outline();
+    for (std::vector<Vec2>& polygon : polygons) {
+        std::vector<Vec2> sums;
+        sums.reserve(polygon.size() * outline.size());
+        for (const Vec2& v : polygon) {
+            for (const Vec2& o : outline) sums.push_back(v + o);
+        }
+        polygon = convexHull(sums);
+    }
+}
+
+ObstacleIndex::ObstacleIndex(const ObstacleRect* rects, size_t count, float cellSize)
+    : rects(rects), count(count), originX(0), originY(0), cellSize(cellSize), cols(0), rows(0) {
+    if (count <= LINEAR_SCAN_LIMIT) return;
+
+    float maxX = rects[0].maxX, maxY = rects[0].maxY;
+    originX = rects[0].minX;
+    originY = rects[0].minY;
+    for (size_t i = 1; i < count; ++i) {
+        originX = std::min(originX, rects[i].minX);
+        originY = std::min(originY, rects[i].minY);
+        maxX = std::max(maxX, rects[i].maxX);
+        maxY = std::max(maxY, rects[i].maxY);
+    }
+    const float width = std::max(maxX - originX, 1.0f);
+    const float height = std::max(maxY - originY, 1.0f);
+
+    if (this->cellSize <= 0.0f) {
+        this->cellSize = std::sqrt(width * height / (count / 2.0f));
+    }
+    this->cellSize = std::max(this->cellSize, std::max(width, height) / MAX_CELLS_PER_AXIS);
+    cols = static_cast<int>(std::ceil(width / this->cellSize)) + 1;
+    rows = static_cast<int>(std::ceil(height / this->cellSize)) + 1;
+
+    // counting pass, then fill (compressed rows, one allocation per array)
+    const size_t cells = static_cast<size_t>(cols) * rows;
+    cellStart.assign(cells + 1, 0);
+    for (size_t i = 0; i < count; ++i) {
+        int c0, r0, c1, r1;
+        cellRange(rects[i].minX, rects[i].minY, rects[i].maxX, rects[i].maxY, c0, r0, c1, r1);
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                cellStart[static_cast<size_t>(r) * cols + c + 1]++;
+            }
+        }
+    }
+    for (size_t i = 0; i < cells; ++i) {
+        cellStart[i + 1] += cellStart[i];
+    }
+
+    items.resize(cellStart[cells]);
+    std::vector<uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < count; ++i) {
+        int c0, r0, c1, r1;
+        cellRange(rects[i].minX, rects[i].minY, rects[i].maxX, rects[i].maxY, c0, r0, c1, r1);
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                items[fill[static_cast<size_t>(r) * cols + c]++] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+}
+
+bool ObstacleIndex::segmentFree(float x1, float y1, float x2, float y2) const {
+    if (cols == 0) {
+        for (size_t i = 0; i < count; ++i) {
+            if (crossesInterior(rects[i], x1, y1, x2, y2)) return false;
+        }
+        return true;
+    }
+
+    // walk the grid row by row, visiting only the columns the segment spans inside each row
+    if (y1 > y2) {
+        std::swap(x1, x2);
+        std::swap(y1, y2);
+    }
+    int c0, r0, c1, r1;
+    cellRange(std::min(x1, x2), y1, std::max(x1, x2), y2, c0, r0, c1, r1);
+
+    const float dy = y2 - y1;
+    for (int r = r0; r <= r1; ++r) {
+        float rowX1 = x1, rowX2 = x2;
+        if (dy > 0.0f) {
+            const float top = std::max(y1, originY + r * cellSize);
+            const float bottom = std::min(y2, originY + (r + 1) * cellSize);
+            rowX1 = x1 + (x2 - x1) * (top - y1) / dy;
+            rowX2 = x1 + (x2 - x1) * (bottom - y1) / dy;
+        }
+        // padded so rounding at a row boundary cannot drop the neighbouring column
+        const float pad = cellSize * 1e-3f;
+        int rc0, rr0, rc1, rr1;
+        cellRange(std::min(rowX1, rowX2) - pad, y1, std::max(rowX1, rowX2) + pad, y1, rc0, rr0, rc1, rr1);
+
+        for (int c = rc0; c <= rc1; ++c) {
+            const size_t cell = static_cast<size_t>(r) * cols + c;
+            for (uint32_t k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                if (crossesInterior(rects[items[k]], x1, y1, x2, y2)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool ObstacleIndex::segmentCrosses(size_t i, float x1, float y1, float x2, float y2) const {
+    // same endpoint order as the grid walk in segmentFree, so both give the same answer
+    if (y1 > y2) {
+        std::swap(x1, x2);
+        std::swap(y1, y2);
+    }
+    return crossesInterior(rects[i], x1, y1, x2, y2);
+}
+
+
+PolygonSet::PolygonSet(const std::vector<std::vector<Vec2> >& polygons) {
+    first.push_back(0);
+    for (auto& polygon : polygons) {
+        const std::vector<Vec2> hull = convexHull(polygon);
+        if (hull.size() < 3) continue;
+
+        ObstacleRect box = {hull[0][0], hull[0][1], hull[0][0], hull[0][1]};
+        for (size_t i = 0; i < hull.size(); ++i) {
+            const Vec2& a = hull[i];
+            const Vec2& b = hull[(i + 1) % hull.size()];
+            // the hull turns counter-clockwise, so the outside is on the right of each edge
+            Vec2 normal{b[1] - a[1], a[0] - b[0]};
+            normal /= std::sqrt(squaredNorm(normal));
+
+            float low = project(normal, hull[0]);
+            for (const Vec2& v : hull) low = std::min(low, project(normal, v));
+
+            vertices.push_back(a);
+            normals.push_back(normal);
+            lowest.push_back(low);
+            highest.push_back(project(normal, a));
+
+            box.minX = std::min(box.minX, a[0]);
+            box.minY = std::min(box.minY, a[1]);
+            box.maxX = std::max(box.maxX, a[0]);
+            box.maxY = std::max(box.maxY, a[1]);
+        }
+        first.push_back(static_cast<uint32_t>(vertices.size()));
+        bounds.push_back(box);
+    }
+    index.reset(new ObstacleIndex(bounds.data(), bounds.size()));
+}
+
+bool PolygonSet::crossesInterior(size_t polygon, const Vec2& p1, const Vec2& p2) const {
+    // separating axis test: the polygon's edge normals, then the segment's own normal
+    for (uint32_t k = first[polygon]; k < first[polygon + 1]; ++k) {
+        const float a = project(normals[k], p1), b = project(normals[k], p2);
+        if (std::min(a, b) >= highest[k] - GRAZE_EPSILON || std::max(a, b) <= lowest[k] + GRAZE_EPSILON) return false;
+    }
+
+    const Vec2 d = p2 - p1;
+    const float length2 = squaredNorm(d);
+    if (length2 == 0.0f) return true;
+
+    const Vec2 normal = Vec2{-d[1], d[0]} / std::sqrt(length2);
+    const float s = project(normal, p1);
+    float low = std::numeric_limits<float>::max(), high = -low;
+    for (uint32_t k = first[polygon]; k < first[polygon + 1]; ++k) {
+        const float v = project(normal, vertices[k]);
+        low = std::min(low, v);
+        high = std::max(high, v);
+    }
+    return s > low + GRAZE_EPSILON && s < high - GRAZE_EPSILON;
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+#include "utils.h"
+
+// Axis-aligned obstacle, 16 bytes. This is also the on-disk record of the scenario format,
+// so the layout must not change without bumping the scenario version.
+struct ObstacleRect {
+    float minX, minY, maxX, maxY;
+};
+
+// Shape of the robot around its reference point. The planners only translate the robot,
+// so a rectangle keeps its axis-aligned orientation.
+struct Footprint {
+    float halfWidth, halfHeight;    // bounding box around the reference point
+    float radius;                   // > 0 for a disc
+
+    static Footprint point() { return Footprint{0.0f, 0.0f, 0.0f}; }
+    static Footprint disc(float radius) { return Footprint{radius, radius, radius}; }
+    static Footprint rectangle(float width, float height) { return Footprint{width / 2.0f, height / 2.0f, 0.0f}; }
+
+    bool isPoint() const { return halfWidth <= 0.0f && halfHeight <= 0.0f; }
+
+    // convex outline around the origin; a disc is replaced by the regular polygon around it
+    std::vector<Vec2> outline() const;
+};
+
+// Minkowski sum of every obstacle with the footprint, so that the robot is free exactly where
+// its reference point is free of the inflated obstacles. Rectangles grow by the footprint's half
+// extents and stay rectangles (for a disc this rounds the corners up to square ones); polygons
+// become the hull of their vertices offset by the footprint outline.
+void inflateObstacles(const Footprint& footprint, std::vector<ObstacleRect>& rects,
+                      std::vector<std::vector<Vec2> >& polygons);
+
+// world-space bounding boxes; a rotated rectangle becomes the box around it
+std::vector<ObstacleRect> toObstacleRects(const std::vector<sf::RectangleShape>& obstacles);
+
+// corners of the shape with its transform applied once
+std::vector<Vec2> worldCorners(const sf::Shape& shape);
+
+// convex hull of the points in counter-clockwise order (y down), collinear points dropped
+std::vector<Vec2> convexHull(std::vector<Vec2> points);
+
+// Converts the GUI shapes once per run: rectangles rotated by a multiple of 90 degrees go to
+// rects, the other rectangles and the convex shapes go to polygons as world-space corners
+void splitObstacles(const std::vector<sf::RectangleShape>& obstacles, const std::vector<sf::ConvexShape>& shapes,
+                    std::vector<ObstacleRect>& rects, std::vector<std::vector<Vec2> >& polygons);
+
+
+////////////////////////////////////////////////////
+//
+// Uniform grid over a borrowed array of rectangles (e.g. straight from a
+// memory-mapped scenario). Only the grid buckets are allocated, the
+// rectangles themselves are never copied.
+//
+////////////////////////////////////////////////////
+class ObstacleIndex {
+public:
+    // cellSize <= 0 picks a size that puts about two obstacles in each cell
+    ObstacleIndex(const ObstacleRect* rects, size_t count, float cellSize = 0.0f);
+
+    // true when the box does not reach into the interior of any obstacle; the box may be
+    // degenerate (a point, or the bounding box of a horizontal or vertical edge)
+    bool boxFree(float minX, float minY, float maxX, float maxY) const {
+        return !anyOverlapping(minX, minY, maxX, maxY, [](size_t) { return true; });
+    }
+
+    // true when test(i) holds for an obstacle i that strictly overlaps the box; an obstacle
+    // spread over several grid cells may be tested more than once
+    template <class Test>
+    bool anyOverlapping(float minX, float minY, float maxX, float maxY, Test test) const {
+        if (cols == 0) {
+            for (size_t i = 0; i < count; ++i) {
+                if (overlaps(rects[i], minX, minY, maxX, maxY) && test(i)) return true;
+            }
+            return false;
+        }
+
+        int c0, r0, c1, r1;
+        cellRange(minX, minY, maxX, maxY, c0, r0, c1, r1);
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                const size_t cell = static_cast<size_t>(r) * cols + c;
+                for (uint32_t k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                    if (overlaps(rects[items[k]], minX, minY, maxX, maxY) && test(items[k])) return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // exact test: true when the segment does not pass through the interior of any obstacle
+    // (running along an edge or touching a corner is allowed)
+    bool segmentFree(float x1, float y1, float x2, float y2) const;
+
+    // the test segmentFree applies to each obstacle, for obstacle i alone
+    bool segmentCrosses(size_t i, float x1, float y1, float x2, float y2) const;
+
+    const ObstacleRect* data() const { return rects; }
+    size_t size() const { return count; }
+
+private:
+    // closed box against the open rectangle, so a zero-width box inside it still counts
+    static bool overlaps(const ObstacleRect& o, float minX, float minY, float maxX, float maxY) {
+        return minX < o.maxX && maxX > o.minX && minY < o.maxY && maxY > o.minY;
+    }
+
+    void cellRange(float minX, float minY, float maxX, float maxY, int& c0, int& r0, int& c1, int& r1) const {
+        c0 = clampCol(static_cast<int>(std::floor((minX - originX) / cellSize)));
+        c1 = clampCol(static_cast<int>(std::floor((maxX - originX) / cellSize)));
+        r0 = clampRow(static_cast<int>(std::floor((minY - originY) / cellSize)));
+        r1 = clampRow(static_cast<int>(std::floor((maxY - originY) / cellSize)));
+    }
+
+    int clampCol(int c) const { return std::min(std::max(c, 0), cols - 1); }
+    int clampRow(int r) const { return std::min(std::max(r, 0), rows - 1); }
+
+    const ObstacleRect* rects;
+    size_t count;
+
+    // cols == 0 means the set is small enough to be scanned linearly
+    float originX, originY, cellSize;
+    int cols, rows;
+    std::vector<uint32_t> cellStart;   // items of cell i are items[cellStart[i] .. cellStart[i + 1])
+    std::vector<uint32_t> items;
+};
+
+
+////////////////////////////////////////////////////
+//
+// Convex polygons in world space (rotated rectangles, placed polygons).
+// Vertices, outward edge normals and the extent of each polygon along
+// its normals are computed once; a segment test is then a box query on
+// an ObstacleIndex over the polygon bounds followed by a separating
+// axis test against the few candidates, without any transform.
+//
+////////////////////////////////////////////////////
+class PolygonSet {
+public:
+    // each polygon must be convex, in either winding; fewer than three distinct vertices are dropped
+    explicit PolygonSet(const std::vector<std::vector<Vec2> >& polygons);
+
+    // the index points into bounds
+    PolygonSet(const PolygonSet&) = delete;
+    PolygonSet& operator=(const PolygonSet&) = delete;
+
+    // true when the segment does not pass through the interior of any polygon; a zero-length
+    // segment tests a single state
+    bool segmentFree(const Vec2& p1, const Vec2& p2) const {
+        return !index->anyOverlapping(std::min(p1[0], p2[0]), std::min(p1[1], p2[1]),
+                                      std::max(p1[0], p2[0]), std::max(p1[1], p2[1]),
+                                      [&](size_t i) { return crossesInterior(i, p1, p2); });
+    }
+
+    size_t size() const { return bounds.size(); }
+    const ObstacleRect& getBounds(size_t polygon) const { return bounds[polygon]; }
+
+private:
+    bool crossesInterior(size_t polygon, const Vec2& p1, const Vec2& p2) const;
+
+    std::vector<Vec2> vertices;         // polygon i owns vertices[first[i] .. first[i + 1])
+    std::vector<uint32_t> first;
+    std::vector<Vec2> normals;          // outward unit normal of the edge starting at each vertex
+    std::vector<float> lowest;          // min over the polygon of normal . vertex, per edge
+    std::vector<float> highest;         // normal . (edge start), the polygon lies below it
+    std::vector<ObstacleRect> bounds;
+    std::unique_ptr<ObstacleIndex> index;   // over bounds
+};
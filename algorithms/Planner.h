@@ -0,0 +1,337 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <atomic>
+#include "utils.h"
+#include "Policies.h"
+#include "TreeSnapshot.h"
+#include "DeltaQueue.h"
+
+////////////////////////////////////////////////////
+//
+// Single planner core shared by every sampling planner.
+// The behaviour is chosen at compile time by the policies (see Policies.h):
+//
+//   Sampler          sample / report                      -> point to grow towards, node it produced (or null)
+//   NearestIndex     insert / nearest / near / nearestBatch
+//   CollisionChecker edgeFree / edgeFreeBatch
+//   Metric           distance / distance2 / steer / nearest, defines the State type
+//   Extender         extend / insert / reached / appendPath
+//
+// A new variant is just another instantiation, e.g.
+//   typedef Planner<UniformSampler, LinearIndex<EuclideanMetric<2> >, AABBCollision, EuclideanMetric<2>, StepExtender> MyRRT;
+//
+// States are VecN<D>, D being fixed at compile time by the metric. Drawing
+// uses the first two components, so the window shows the (x, y) projection.
+//
+////////////////////////////////////////////////////
+template <class Sampler, class NearestIndex, class CollisionChecker, class Metric, class Extender>
+class Planner {
+public:
+    typedef NearestIndex IndexType;
+    typedef Metric MetricType;
+    typedef typename Metric::State State;
+    typedef typename NearestIndex::NodeType NodeType;
+
+    // Samples are drawn inside [0, 1]^D until setBounds() is called
+    Planner(const char* name, sf::Color color, const State& start, const State& goal, const CollisionChecker& checker, float stepSize = 10.0f, float radius = 50.0f)
+        : name(name), color(color), checker(checker), start(start), goal(goal), stepSize(stepSize), radius(radius), pathLength(0), iterations(0), verbose(true), recorder(nullptr), publisher(nullptr), cancel(nullptr), goalNode(nullptr) {
+        for (int d = 0; d < State::dimension; ++d) {
+            lower[d] = 0.0f;
+            upper[d] = 1.0f;
+        }
+        tree.insert(new NodeType(start));
+        extender.init(*this);
+    }
+
+    Planner(const Planner&) = delete;
+    Planner& operator=(const Planner&) = delete;
+
+    bool run(int maxIterations = 100000) {
+        for (int it = 1; it <= maxIterations && !cancelled(); ++it) {
+            NodeType* newNode = extender.extend(*this, sampler.sample(*this));
+            sampler.report(*this, newNode);
+            if (newNode) observe(it);
+            if (newNode && extender.reached(*this, newNode)) {
+                return finish(newNode, it);
+            }
+        }
+        return false;
+    }
+
+    // Draws K samples per round, resolves the K nearest nodes in one pass over the tree,
+    // checks the K steered edges together and inserts the survivors. The last round is
+    // shortened so exactly maxIterations samples are drawn. Only for extenders whose extend()
+    // is a plain steer (not RRT-Connect or the local search).
+    bool runBatched(int batchSize = 32, int maxIterations = 100000) {
+        static_assert(Extender::plainSteer, "runBatched needs an extender whose extend() is a plain steer");
+        if (batchSize < 1) {
+            std::cerr << "runBatched: batchSize must be at least 1\n";
+            return false;
+        }
+
+        std::vector<State> samples, from, to;
+        std::vector<NodeType*> nearest;
+        std::vector<char> isFree;
+
+        for (int done = 0; done < maxIterations && !cancelled(); ) {
+            const int k = std::min(batchSize, maxIterations - done);
+            samples.resize(k);
+            from.resize(k);
+            to.resize(k);
+            for (auto& sample : samples) {
+                sample = sampler.sample(*this);
+            }
+
+            tree.nearestBatch(samples, nearest);
+
+            for (int i = 0; i < k; ++i) {
+                from[i] = nearest[i]->position;
+                to[i] = steer(from[i], samples[i]);
+            }
+            checker.edgeFreeBatch(from, to, isFree);
+
+            for (int i = 0; i < k; ++i) {
+                const int it = done + i + 1;
+                NodeType* newNode = isFree[i] ? extender.insert(*this, nearest[i], to[i]) : nullptr;
+                sampler.report(*this, newNode);
+                if (newNode) observe(it);
+                if (newNode && extender.reached(*this, newNode)) {
+                    return finish(newNode, it);
+                }
+            }
+            done += k;
+        }
+        return false;
+    }
+
+    struct GoalPath {
+        bool reached;
+        float cost;                 // cost-to-come of the goal through the tree
+        std::vector<State> path;    // start ... goal, empty when not reached
+    };
+
+    // One start, many goals: grows the single tree until every goal can be linked to it
+    // or the budget runs out, then connects each goal to the cheapest free node within the
+    // radius. Only for single-tree extenders (not RRT-Connect). goalBias is the chance of
+    // steering towards a goal not yet reachable.
+    // Returns how many goals were reached.
+    int runMultiGoal(const std::vector<State>& goals, std::vector<GoalPath>& results, int maxIterations = 100000, float goalBias = 0.05f) {
+        static_assert(Extender::singleTree, "runMultiGoal links the goals to the planner's own tree only");
+        std::vector<size_t> pending(goals.size());
+        for (size_t g = 0; g < goals.size(); ++g) pending[g] = g;
+
+        int it = 0;
+        while (!pending.empty() && it < maxIterations && !cancelled()) {
+            ++it;
+            State sample = sampler.sample(*this);
+            if (randfloat(0.0f, 1.0f) < goalBias) {
+                sample = goals[pending[randint(0, static_cast<int>(pending.size()) - 1)]];
+            }
+
+            NodeType* newNode = extender.extend(*this, sample);
+            sampler.report(*this, newNode);
+            if (!newNode) continue;
+            observe(it);
+
+            for (size_t i = 0; i < pending.size(); ) {
+                const State& target = goals[pending[i]];
+                if (Metric::distance(newNode->position, target) <= radius && checker.edgeFree(newNode->position, target)) {
+                    pending[i] = pending.back();
+                    pending.pop_back();
+                } else {
+                    ++i;
+                }
+            }
+        }
+        iterations = it;
+
+        // link every goal to the tree once it is final, so each one gets the best parent
+        int reached = 0;
+        results.assign(goals.size(), GoalPath());
+        std::vector<NodeType*> nearby;
+        for (size_t g = 0; g < goals.size(); ++g) {
+            GoalPath& result = results[g];
+            result.reached = false;
+            result.cost = std::numeric_limits<float>::max();
+
+            NodeType* parent = nullptr;
+            tree.near(goals[g], radius, nearby);
+            for (NodeType* candidate : nearby) {
+                const float cost = candidate->cost + Metric::distance(candidate->position, goals[g]);
+                if (cost < result.cost && checker.edgeFree(candidate->position, goals[g])) {
+                    result.cost = cost;
+                    parent = candidate;
+                }
+            }
+            if (!parent) continue;
+
+            result.reached = true;
+            for (NodeType* current = parent; current != nullptr; current = current->parent) {
+                result.path.push_back(current->position);
+            }
+            std::reverse(result.path.begin(), result.path.end());
+            result.path.push_back(goals[g]);
+            ++reached;
+        }
+
+        if (verbose) {
+            std::cout << "final " << name << " It: " << iterations << "\n";
+            std::cout << "final " << name << " Goals: " << reached << "/" << goals.size() << "\n";
+        }
+        return reached;
+    }
+
+    float getPathDistance() const { return pathLength; }
+    std::vector<State> getPath() const { return path; }
+    int getIterations() const { return iterations; }
+
+    // when false the final iteration count and distance are not printed
+    void setVerbose(bool enabled) { verbose = enabled; }
+
+    // streams every node of the tree, and the path once found, to an open recorder (null stops it).
+    // Only the planner's own tree is recorded, not RRT-Connect's goal tree
+    void setRecorder(TreeRecorder* treeRecorder) { recorder = treeRecorder; }
+
+    // sends every new edge, and the path once found, to a live view (null stops it); same scope as the recorder
+    void setPublisher(TreePublisher* treePublisher) { publisher = treePublisher; }
+
+    // the run loops stop before their next iteration once the flag is set, e.g. by another
+    // thread (null never stops them)
+    void setCancel(const std::atomic<bool>* flag) { cancel = flag; }
+
+    void setBounds(const State& lowerBound, const State& upperBound) {
+        lower = lowerBound;
+        upper = upperBound;
+    }
+
+    void drawPath(sf::RenderWindow& window) const {
+        if (path.empty()) return;
+        std::vector<State> points(1, path[0]);
+        for (size_t i = 1; i < path.size(); ++i) {
+            EdgeShape<Metric>::trace(path[i - 1], path[i], points);
+        }
+        std::vector<sf::Vertex> strip;
+        strip.reserve(points.size());
+        for (const State& p : points) {
+            strip.push_back(sf::Vertex(toVector2f(p), color));
+        }
+        window.draw(strip.data(), strip.size(), sf::LineStrip);
+    }
+
+    void drawTree(sf::RenderWindow& window) const {
+        for (const auto& node : tree.all()) {
+            if (node->parent) {
+                sf::Vertex line[] = {
+                    sf::Vertex(toVector2f(node->position), sf::Color(100,100,100,80)),
+                    sf::Vertex(toVector2f(node->parent->position), sf::Color(100,100,100,80))
+                };
+                window.draw(line, 2, sf::Lines);
+            }
+        }
+    }
+
+    // Accessors used by the policies
+    NearestIndex& index() { return tree; }
+    const NearestIndex& index() const { return tree; }
+    const CollisionChecker& collision() const { return checker; }
+    const State& getStart() const { return start; }
+    const State& getGoal() const { return goal; }
+    const State& getLower() const { return lower; }
+    const State& getUpper() const { return upper; }
+    float getStepSize() const { return stepSize; }
+    float getRadius() const { return radius; }
+
+    State steer(const State& from, const State& towards) const {
+        return Metric::steer(from, towards, stepSize);
+    }
+
+    NodeType* addNode(const State& point, NodeType* parent) {
+        NodeType* node = new NodeType(point, parent, parent->cost + Metric::distance(parent->position, point));
+        tree.insert(node);
+        return node;
+    }
+
+private:
+    bool cancelled() const { return cancel && cancel->load(std::memory_order_relaxed); }
+
+    // after an iteration that inserted nodes
+    void observe(int iteration) {
+        if (recorder) recorder->record(*this, iteration);
+        if (publisher) publisher->publish(*this);
+    }
+
+    bool finish(NodeType* node, int iterationCount) {
+        goalNode = node;
+        iterations = iterationCount;
+
+        path.clear();
+        for (NodeType* current = goalNode; current != nullptr; current = current->parent) {
+            path.push_back(current->position);
+        }
+        std::reverse(path.begin(), path.end());
+        extender.appendPath(*this, path);
+        if (path.back() != goal) path.push_back(goal);
+
+        pathLength = 0;
+        for (size_t i = 1; i < path.size(); ++i) {
+            pathLength += EdgeShape<Metric>::length(path[i - 1], path[i]);
+        }
+        if (recorder) recorder->recordPath(path);
+        if (publisher) publisher->publishPath(path);
+
+        if (verbose) {
+            std::cout << "final " << name << " It: " << iterations << "\n";
+            std::cout << "final " << name << " Distance: " << pathLength << "\n";
+        }
+        return true;
+    }
+
+    const char* name;
+    sf::Color color;
+
+    Sampler sampler;
+    NearestIndex tree;
+    CollisionChecker checker;
+    Extender extender;
+
+    State start;
+    State goal;
+    State lower;
+    State upper;
+    float stepSize;
+    float radius;
+
+    std::vector<State> path;
+    float pathLength;
+    int iterations;
+    bool verbose;
+    TreeRecorder* recorder;
+    TreePublisher* publisher;
+    const std::atomic<bool>* cancel;
+    NodeType* goalNode;
+};
+
+
+////////////////////////////////////////////////////
+//
+// N-dimensional planners driven by a state-validity callback, e.g. for a 6-DOF arm:
+//
+//   auto valid = [&](const VecN<6>& q) { return !arm.inCollision(q); };
+//   RRTN<6, decltype(valid)> planner("arm", sf::Color::White, start, goal, ValidityChecker<6, decltype(valid)>(valid, 0.01f), 0.1f);
+//   planner.setBounds(jointMin, jointMax);
+//
+////////////////////////////////////////////////////
+template <int D, class Validity = std::function<bool(const VecN<D>&)> >
+using RRTN = Planner<UniformSampler, LinearIndex<EuclideanMetric<D> >, ValidityChecker<D, Validity>, EuclideanMetric<D>, StepExtender>;
+
+template <int D, class Validity = std::function<bool(const VecN<D>&)> >
+using RRTStarN = Planner<UniformSampler, LinearIndex<EuclideanMetric<D> >, ValidityChecker<D, Validity>, EuclideanMetric<D>, RewireExtender<LinearIndex<EuclideanMetric<D> > > >;
+
+template <int D, class Validity = std::function<bool(const VecN<D>&)> >
+using RRTConnectN = Planner<UniformSampler, LinearIndex<EuclideanMetric<D> >, ValidityChecker<D, Validity>, EuclideanMetric<D>, ConnectExtender<LinearIndex<EuclideanMetric<D> > > >;
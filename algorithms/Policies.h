@@ -0,0 +1,694 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <deque>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include "utils.h"
+#include "Obstacles.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+////////////////////////////////////////////////////
+//
+// Compile-time policies plugged into Planner<...> (Planner.h).
+// Every policy is a plain type whose members are defined here so the
+// compiler can inline them into the planner's hot loop.
+//
+// States are fixed-size VecN<D>; the dimension comes from the metric.
+//
+////////////////////////////////////////////////////
+
+
+// ---------------- Distance metrics ----------------
+
+template <int D>
+struct EuclideanMetric {
+    typedef VecN<D> State;
+
+    static float distance2(const State& p1, const State& p2) {
+        return squaredDistance(p1, p2);
+    }
+
+    static float distance(const State& p1, const State& p2) {
+        return std::sqrt(distance2(p1, p2));
+    }
+
+    // unit vector pointing from p1 to p2
+    static State direction(const State& p1, const State& p2) {
+        State d = p2 - p1;
+        return d / std::sqrt(squaredNorm(d));
+    }
+
+    // point reached after moving stepSize from `from` straight towards `towards`
+    static State steer(const State& from, const State& towards, float stepSize) {
+        return from + direction(from, towards) * stepSize;
+    }
+
+    // index of the closest of count points stored as coords[d][i]; distances are always measured
+    // from the stored point to the query, which matters for asymmetric metrics
+    static size_t nearest(const float* const coords[D], size_t count, const State& point) {
+        float best;
+        return nearestSquared<D>(coords, count, point, best);
+    }
+};
+
+// Same metric, but directions are normalized with the hardware reciprocal square root
+template <int D>
+struct RsqrtEuclideanMetric : EuclideanMetric<D> {
+    typedef VecN<D> State;
+
+    static State direction(const State& p1, const State& p2) {
+        State d = p2 - p1;
+        return d * rsqrt(squaredNorm(d));
+    }
+
+    static State steer(const State& from, const State& towards, float stepSize) {
+        return from + direction(from, towards) * stepSize;
+    }
+
+    static float rsqrt(float f) {
+#if defined(__x86_64__) || defined(_M_X64)
+        return _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(f)));
+#else
+        return 1.0f / std::sqrt(f);
+#endif
+    }
+};
+
+// Geometry of a tree edge for reporting and drawing the path. Straight by default; metrics whose
+// distance is only an estimate of the driven edge (CurveMetric) specialize it.
+template <class Metric>
+struct EdgeShape {
+    typedef typename Metric::State State;
+
+    static float length(const State& from, const State& to) {
+        return Metric::distance(from, to);
+    }
+
+    // appends the points after `from` that trace the edge
+    static void trace(const State& from, const State& to, std::vector<State>& points) {
+        (void)from;
+        points.push_back(to);
+    }
+};
+
+
+// ---------------- Samplers ----------------
+
+// Samplers that ignore the extension feedback
+struct SamplerBase {
+    template <class P>
+    void report(const P&, const typename P::NodeType*) {}
+};
+
+// A state is free when the zero-length edge at it is, which every collision policy answers
+template <class P>
+bool stateFree(const P& planner, const typename P::State& s) {
+    return planner.collision().edgeFree(s, s);
+}
+
+// Uniform sample inside the planner bounds
+struct UniformSampler : SamplerBase {
+    template <class P>
+    typename P::State sample(const P& planner) {
+        typename P::State s;
+        for (int d = 0; d < P::State::dimension; ++d) {
+            s[d] = randfloat(planner.getLower()[d], planner.getUpper()[d]);
+        }
+        return s;
+    }
+};
+
+// Always samples the goal, the extension strategy is responsible for getting around obstacles
+struct GoalSampler : SamplerBase {
+    template <class P>
+    typename P::State sample(const P& planner) {
+        return planner.getGoal();
+    }
+};
+
+// The goal Percent% of the time, Base otherwise
+template <class Base = UniformSampler, int Percent = 10>
+struct GoalBiasedSampler : Base {
+    template <class P>
+    typename P::State sample(const P& planner) {
+        if (randint(0, 99) < Percent) return planner.getGoal();
+        return Base::sample(planner);
+    }
+};
+
+// Gaussian sampling: a uniform state and a normally perturbed copy (sigma = 2 steps);
+// when exactly one of them is free that one is returned, which concentrates samples
+// along obstacle boundaries. Falls back to uniform after a few attempts.
+struct GaussianSampler : SamplerBase {
+    static const int ATTEMPTS = 20;
+
+    template <class P>
+    typename P::State sample(const P& planner) {
+        return sampleIn(planner, planner.getLower(), planner.getUpper());
+    }
+
+    template <class P>
+    static typename P::State sampleIn(const P& planner, const typename P::State& lower, const typename P::State& upper) {
+        typedef typename P::State State;
+        const float sigma = 2.0f * planner.getStepSize();
+        for (int attempt = 0; attempt < ATTEMPTS; ++attempt) {
+            State a = uniformIn<State>(lower, upper), b = a;
+            for (int d = 0; d < State::dimension; ++d) b[d] = randnormal(a[d], sigma);
+
+            const bool aFree = stateFree(planner, a), bFree = stateFree(planner, b);
+            if (aFree != bFree) return aFree ? a : b;
+        }
+        return uniformIn<State>(lower, upper);
+    }
+
+    template <class State>
+    static State uniformIn(const State& lower, const State& upper) {
+        State s;
+        for (int d = 0; d < State::dimension; ++d) s[d] = randfloat(lower[d], upper[d]);
+        return s;
+    }
+};
+
+// Bridge test: two blocked states about 3 steps apart whose midpoint is free,
+// i.e. a point inside a gap between obstacles. Falls back to uniform after a few attempts.
+struct BridgeSampler : SamplerBase {
+    static const int ATTEMPTS = 20;
+
+    template <class P>
+    typename P::State sample(const P& planner) {
+        return sampleIn(planner, planner.getLower(), planner.getUpper());
+    }
+
+    template <class P>
+    static typename P::State sampleIn(const P& planner, const typename P::State& lower, const typename P::State& upper) {
+        typedef typename P::State State;
+        const float sigma = 3.0f * planner.getStepSize();
+        for (int attempt = 0; attempt < ATTEMPTS; ++attempt) {
+            State a = GaussianSampler::uniformIn<State>(lower, upper);
+            if (stateFree(planner, a)) continue;
+
+            State b = a;
+            for (int d = 0; d < State::dimension; ++d) b[d] = randnormal(a[d], sigma);
+            if (stateFree(planner, b)) continue;
+
+            const State middle = (a + b) * 0.5f;
+            if (stateFree(planner, middle)) return middle;
+        }
+        return GaussianSampler::uniformIn<State>(lower, upper);
+    }
+};
+
+// Adaptive mixture. The (x, y) bounds are split into Regions x Regions cells; every draw
+// picks a cell and a strategy (uniform, Gaussian, bridge or goal), each in proportion to
+// its weight, and samples that strategy inside the cell. report() rewards the cell and
+// strategy of the oldest unreported draw when its extension added a node, more so when
+// the node landed in a cell the tree has barely reached, so weight moves to the frontier
+// (e.g. into a narrow passage) instead of open space that is already covered. Weights are
+// an exponential moving average of the reward, with a floor so nothing starves.
+template <int Regions = 8>
+class AdaptiveSampler {
+public:
+    enum Strategy { UNIFORM, GAUSSIAN, BRIDGE, GOAL, STRATEGIES };
+
+    AdaptiveSampler() : regionWeights(Regions * Regions, 1.0f), regionNodes(Regions * Regions, 0) {
+        for (int i = 0; i < STRATEGIES; ++i) strategyWeights[i] = 1.0f;
+    }
+
+    template <class P>
+    typename P::State sample(const P& planner) {
+        typedef typename P::State State;
+
+        Draw draw;
+        draw.strategy = pick(strategyWeights, STRATEGIES);
+        draw.region = draw.strategy == GOAL ? -1 : pick(regionWeights.data(), Regions * Regions);
+        pending.push_back(draw);
+
+        if (draw.strategy == GOAL) return planner.getGoal();
+
+        // the cell only narrows the first two components
+        State lower = planner.getLower(), upper = planner.getUpper();
+        const float cellX = (upper[0] - lower[0]) / Regions, cellY = (upper[1] - lower[1]) / Regions;
+        lower[0] += cellX * (draw.region % Regions);
+        lower[1] += cellY * (draw.region / Regions);
+        upper[0] = lower[0] + cellX;
+        upper[1] = lower[1] + cellY;
+
+        switch (draw.strategy) {
+        case GAUSSIAN: return GaussianSampler::sampleIn(planner, lower, upper);
+        case BRIDGE: return BridgeSampler::sampleIn(planner, lower, upper);
+        default: return GaussianSampler::uniformIn<State>(lower, upper);
+        }
+    }
+
+    template <class P>
+    void report(const P& planner, const typename P::NodeType* node) {
+        if (pending.empty()) return;
+        const Draw draw = pending.front();
+        pending.pop_front();
+
+        float reward = 0.0f;
+        if (node) {
+            const int cell = regionOf(planner, node->position);
+            reward = 1.0f / (1.0f + regionNodes[cell] / static_cast<float>(NODES_PER_REGION));
+            ++regionNodes[cell];
+        }
+        update(strategyWeights[draw.strategy], reward);
+        if (draw.region >= 0) update(regionWeights[draw.region], reward);
+    }
+
+private:
+    // nodes after which a cell's reward has halved
+    static const int NODES_PER_REGION = 16;
+
+    struct Draw {
+        int strategy;
+        int region;
+    };
+
+    template <class P>
+    static int regionOf(const P& planner, const typename P::State& s) {
+        const typename P::State& lower = planner.getLower();
+        const typename P::State& upper = planner.getUpper();
+        const int x = static_cast<int>((s[0] - lower[0]) / (upper[0] - lower[0]) * Regions);
+        const int y = static_cast<int>((s[1] - lower[1]) / (upper[1] - lower[1]) * Regions);
+        return std::min(std::max(y, 0), Regions - 1) * Regions + std::min(std::max(x, 0), Regions - 1);
+    }
+
+    static void update(float& weight, float reward) {
+        const float rate = 0.1f, floor = 0.05f;
+        weight = std::max(floor, (1.0f - rate) * weight + rate * reward);
+    }
+
+    static int pick(const float* weights, int count) {
+        float total = 0.0f;
+        for (int i = 0; i < count; ++i) total += weights[i];
+        float r = randfloat(0.0f, total);
+        for (int i = 0; i < count; ++i) {
+            r -= weights[i];
+            if (r <= 0.0f) return i;
+        }
+        return count - 1;
+    }
+
+    float strategyWeights[STRATEGIES];
+    std::vector<float> regionWeights;
+    std::vector<int> regionNodes;
+    std::deque<Draw> pending;       // draws waiting for their report, in order
+};
+
+
+// ---------------- Nearest-neighbour indexes ----------------
+
+// Brute force index; positions are mirrored in one flat array per component so the scans vectorize.
+// The index owns the nodes inserted into it.
+template <class Metric>
+class LinearIndex {
+public:
+    typedef typename Metric::State State;
+    typedef TreeNode<State> NodeType;
+    static const int D = State::dimension;
+
+    LinearIndex() {}
+    LinearIndex(const LinearIndex&) = delete;
+    LinearIndex& operator=(const LinearIndex&) = delete;
+
+    ~LinearIndex() {
+        for (auto& node : nodes) delete node;
+    }
+
+    void insert(NodeType* node) {
+        node->index = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(node);
+        for (int d = 0; d < D; ++d) coords[d].push_back(node->position[d]);
+    }
+
+    NodeType* nearest(const State& point) const {
+        const float* columns[D];
+        for (int d = 0; d < D; ++d) columns[d] = coords[d].data();
+        return nodes[Metric::nearest(columns, nodes.size(), point)];
+    }
+
+    void near(const State& point, float radius, std::vector<NodeType*>& out) const {
+        out.clear();
+        const float radius2 = radius * radius;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (Metric::distance2(at(i), point) <= radius2) {
+                out.push_back(nodes[i]);
+            }
+        }
+    }
+
+    // out[i] receives the node closest to samples[i], resolved in a single pass over the tree
+    void nearestBatch(const std::vector<State>& samples, std::vector<NodeType*>& out) const {
+        const size_t k = samples.size();
+        std::vector<float> best(k, std::numeric_limits<float>::max());
+        std::vector<size_t> bestIdx(k, 0);
+
+        for (size_t n = 0; n < nodes.size(); ++n) {
+            const State p = at(n);
+            for (size_t i = 0; i < k; ++i) {
+                float d = Metric::distance2(p, samples[i]);
+                bool closer = d < best[i];
+                best[i] = closer ? d : best[i];
+                bestIdx[i] = closer ? n : bestIdx[i];
+            }
+        }
+
+        out.resize(k);
+        for (size_t i = 0; i < k; ++i) {
+            out[i] = nodes[bestIdx[i]];
+        }
+    }
+
+    const std::vector<NodeType*>& all() const { return nodes; }
+    size_t size() const { return nodes.size(); }
+
+private:
+    State at(size_t i) const {
+        State s;
+        for (int d = 0; d < D; ++d) s[d] = coords[d][i];
+        return s;
+    }
+
+    std::vector<NodeType*> nodes;
+    std::vector<float> coords[D];
+};
+
+
+// ---------------- Collision checkers ----------------
+
+// 2D only: tests the bounding box of an edge against the obstacle rectangles, and the edge
+// itself against the polygons (rotated or convex obstacles) when there are any.
+// Built either from the GUI shapes (converted once, owned) or from a borrowed array such as
+// a memory-mapped scenario (zero copy). Copies share the same storage and grid.
+class AABBCollision {
+public:
+    // rotated rectangles and the convex shapes are kept as exact world-space polygons; every
+    // obstacle is inflated by the robot footprint here, once, so the checks stay point checks
+    explicit AABBCollision(const std::vector<sf::RectangleShape>& obstacles,
+                           const std::vector<sf::ConvexShape>& shapes = std::vector<sf::ConvexShape>(),
+                           const Footprint& footprint = Footprint::point())
+        : owned(std::make_shared<std::vector<ObstacleRect> >()) {
+        std::vector<std::vector<Vec2> > corners;
+        splitObstacles(obstacles, shapes, *owned, corners);
+        inflateObstacles(footprint, *owned, corners);
+        index = std::make_shared<ObstacleIndex>(owned->data(), owned->size());
+        if (!corners.empty()) polygons = std::make_shared<PolygonSet>(corners);
+    }
+
+    // rects must outlive the checker and all of its copies
+    AABBCollision(const ObstacleRect* rects, size_t count)
+        : index(std::make_shared<ObstacleIndex>(rects, count)) {}
+
+    // inflated copy of the rects, owned like the GUI shapes
+    AABBCollision(const ObstacleRect* rects, size_t count, const Footprint& footprint)
+        : owned(std::make_shared<std::vector<ObstacleRect> >(rects, rects + count)) {
+        std::vector<std::vector<Vec2> > corners;
+        inflateObstacles(footprint, *owned, corners);
+        index = std::make_shared<ObstacleIndex>(owned->data(), owned->size());
+    }
+
+    bool edgeFree(const Vec2& p1, const Vec2& p2) const {
+        return index->boxFree(std::min(p1[0], p2[0]), std::min(p1[1], p2[1]),
+                              std::max(p1[0], p2[0]), std::max(p1[1], p2[1])) &&
+               (!polygons || polygons->segmentFree(p1, p2));
+    }
+
+    // isFree[i] is set to 1 when from[i] -> to[i] is free
+    void edgeFreeBatch(const std::vector<Vec2>& from, const std::vector<Vec2>& to, std::vector<char>& isFree) const {
+        const size_t k = from.size();
+        std::vector<float> eMinX(k), eMinY(k), eMaxX(k), eMaxY(k);
+        for (size_t i = 0; i < k; ++i) {
+            eMinX[i] = std::min(from[i][0], to[i][0]);
+            eMaxX[i] = std::max(from[i][0], to[i][0]);
+            eMinY[i] = std::min(from[i][1], to[i][1]);
+            eMaxY[i] = std::max(from[i][1], to[i][1]);
+        }
+
+        isFree.assign(k, 1);
+        if (index->size() > LINEAR_BATCH_LIMIT) {
+            // large maps: each edge only visits the grid cells it touches
+            for (size_t i = 0; i < k; ++i) {
+                isFree[i] = index->boxFree(eMinX[i], eMinY[i], eMaxX[i], eMaxY[i]);
+            }
+        } else {
+            // small maps: obstacles are walked once for the whole batch
+            const ObstacleRect* rects = index->data();
+            for (size_t o = 0; o < index->size(); ++o) {
+                for (size_t i = 0; i < k; ++i) {
+                    bool hit = eMinX[i] < rects[o].maxX && eMaxX[i] > rects[o].minX &&
+                               eMinY[i] < rects[o].maxY && eMaxY[i] > rects[o].minY;
+                    isFree[i] &= !hit;
+                }
+            }
+        }
+
+        if (!polygons) return;
+        for (size_t i = 0; i < k; ++i) {
+            if (isFree[i]) isFree[i] = polygons->segmentFree(from[i], to[i]);
+        }
+    }
+
+    const ObstacleIndex& obstacles() const { return *index; }
+
+private:
+    static const size_t LINEAR_BATCH_LIMIT = 256;
+
+    std::shared_ptr<std::vector<ObstacleRect> > owned;
+    std::shared_ptr<ObstacleIndex> index;
+    std::shared_ptr<const PolygonSet> polygons;     // null when every obstacle is axis-aligned
+};
+
+// Any dimension: edges are sampled every `resolution` units and each state is
+// passed to a user supplied validity callback. Validity can be any callable
+// type; a lambda or functor type (instead of std::function) keeps it inlined.
+template <int D, class Validity = std::function<bool(const VecN<D>&)> >
+class ValidityChecker {
+public:
+    ValidityChecker(Validity isValid, float resolution)
+        : isValid(isValid), resolution(resolution) {}
+
+    bool edgeFree(const VecN<D>& p1, const VecN<D>& p2) const {
+        // p1 is already in the tree, only the states after it are tested
+        const int steps = std::max(1, static_cast<int>(std::ceil(std::sqrt(squaredDistance(p1, p2)) / resolution)));
+        const VecN<D> delta = (p2 - p1) / static_cast<float>(steps);
+        VecN<D> s = p1;
+        for (int i = 1; i <= steps; ++i) {
+            s += delta;
+            if (!isValid(s)) return false;
+        }
+        return true;
+    }
+
+    void edgeFreeBatch(const std::vector<VecN<D> >& from, const std::vector<VecN<D> >& to, std::vector<char>& isFree) const {
+        isFree.resize(from.size());
+        for (size_t i = 0; i < from.size(); ++i) {
+            isFree[i] = edgeFree(from[i], to[i]);
+        }
+    }
+
+private:
+    Validity isValid;
+    float resolution;
+};
+
+
+// ---------------- Extension strategies ----------------
+//
+// extend() runs one full iteration for a sample and returns the inserted node (or nullptr),
+// insert() attaches a point that was already steered and collision checked (batched rounds).
+//
+// plainSteer: extend() is exactly nearest + steer + edgeFree + insert(), so a batched round
+//             can do those steps itself (Planner::runBatched)
+// singleTree: every node lives in the planner's own tree
+
+struct ExtenderBase {
+    static const bool plainSteer = true;
+    static const bool singleTree = true;
+
+    template <class P>
+    void init(P&) {}
+
+    // the planner stops once reached() holds for a returned node; the path ends with the
+    // hop from that node to the goal, so the hop has to be free too
+    template <class P>
+    bool reached(const P& planner, const typename P::NodeType* node) const {
+        return P::MetricType::distance(node->position, planner.getGoal()) < planner.getStepSize() &&
+               planner.collision().edgeFree(node->position, planner.getGoal());
+    }
+
+    // chance to append nodes that do not belong to the main tree
+    template <class P>
+    void appendPath(const P&, std::vector<typename P::State>&) const {}
+};
+
+// One step towards the sample; Derived::insert decides how the new point is attached
+template <class Derived>
+struct SteerExtender : ExtenderBase {
+    template <class P>
+    typename P::NodeType* extend(P& planner, const typename P::State& sample) {
+        typename P::NodeType* nearest = planner.index().nearest(sample);
+        typename P::State newPoint = planner.steer(nearest->position, sample);
+        if (!planner.collision().edgeFree(nearest->position, newPoint)) return nullptr;
+        return static_cast<Derived*>(this)->insert(planner, nearest, newPoint);
+    }
+};
+
+// Plain RRT
+struct StepExtender : SteerExtender<StepExtender> {
+    template <class P>
+    typename P::NodeType* insert(P& planner, typename P::NodeType* parent, const typename P::State& point) {
+        return planner.addNode(point, parent);
+    }
+};
+
+// RRT*: the cheapest parent within the radius is chosen for every new node
+template <class Index>
+struct RewireExtender : SteerExtender<RewireExtender<Index> > {
+    typedef typename Index::NodeType Node;
+
+    template <class P>
+    Node* insert(P& planner, Node* parent, const typename P::State& point) {
+        typedef typename P::MetricType Metric;
+
+        Node* newNode = planner.addNode(point, parent);
+        planner.index().near(point, planner.getRadius(), near);
+        for (auto& nearNode : near) {
+            float cost = nearNode->cost + Metric::distance(nearNode->position, point);
+            if (cost < newNode->cost && planner.collision().edgeFree(nearNode->position, point)) {
+                newNode->parent = nearNode;
+                newNode->cost = cost;
+            }
+        }
+        return newNode;
+    }
+
+private:
+    std::vector<Node*> near;
+};
+
+// Greedy step; when it collides, random points around the nearest node are tried instead
+struct LocalSearchExtender : StepExtender {
+    static const bool plainSteer = false;
+
+    template <class P>
+    typename P::NodeType* extend(P& planner, const typename P::State& sample) {
+        typedef typename P::State State;
+
+        typename P::NodeType* nearest = planner.index().nearest(sample);
+        State newPoint = planner.steer(nearest->position, sample);
+
+        if (!planner.collision().edgeFree(nearest->position, newPoint)) {
+            // search around the collision point
+            const float step = planner.getStepSize();
+            bool found = false;
+            for (int i = 0; i < 1000 && !found; ++i) {
+                State randPoint = nearest->position;
+                for (int d = 0; d < State::dimension; ++d) {
+                    randPoint[d] += randfloat(-step, step);
+                }
+                if (planner.collision().edgeFree(nearest->position, randPoint)) {
+                    newPoint = randPoint;
+                    found = true;
+                }
+            }
+            // add no new nodes
+            if (!found) return nullptr;
+        }
+        return insert(planner, nearest, newPoint);
+    }
+};
+
+// RRT-Connect: alternately grows the planner's tree and a second tree rooted at the goal,
+// every new node is greedily connected from the other tree
+template <class Index>
+struct ConnectExtender : ExtenderBase {
+    static const bool plainSteer = false;
+    static const bool singleTree = false;
+
+    typedef typename Index::NodeType Node;
+    typedef typename Index::State State;
+
+    ConnectExtender() : swapped(false), startSide(nullptr), goalSide(nullptr) {}
+
+    template <class P>
+    void init(P& planner) {
+        goalTree.insert(new Node(planner.getGoal()));
+    }
+
+    template <class P>
+    Node* extend(P& planner, const State& sample) {
+        Index& tree = swapped ? goalTree : planner.index();
+        Node* nearest = tree.nearest(sample);
+        State newPoint = planner.steer(nearest->position, sample);
+        if (!planner.collision().edgeFree(nearest->position, newPoint)) {
+            swapped = !swapped;
+            return nullptr;
+        }
+        return insert(planner, nearest, newPoint);
+    }
+
+    template <class P>
+    Node* insert(P& planner, Node* parent, const State& point) {
+        const bool fromGoal = swapped;
+        swapped = !swapped;
+
+        Node* newNode = new Node(point, parent, parent->cost + P::MetricType::distance(parent->position, point));
+        (fromGoal ? goalTree : planner.index()).insert(newNode);
+
+        Node* joint = connect(planner, fromGoal ? planner.index() : goalTree, point);
+        if (!joint) return newNode;
+
+        startSide = fromGoal ? joint : newNode;
+        goalSide = fromGoal ? newNode : joint;
+        return startSide;
+    }
+
+    template <class P>
+    bool reached(const P&, const Node* node) const {
+        return node == startSide;
+    }
+
+    template <class P>
+    void appendPath(const P&, std::vector<State>& path) const {
+        // skip the connecting node already added from the start tree
+        for (Node* current = goalSide ? goalSide->parent : nullptr; current != nullptr; current = current->parent) {
+            path.push_back(current->position);
+        }
+    }
+
+private:
+    // steps greedily from tree towards target, returns the node placed on target or nullptr
+    template <class P>
+    Node* connect(P& planner, Index& tree, const State& target) {
+        typedef typename P::MetricType Metric;
+
+        while (true) {
+            Node* nearest = tree.nearest(target);
+            State newPoint = planner.steer(nearest->position, target);
+            if (Metric::distance(nearest->position, target) <= planner.getStepSize()) {
+                newPoint = target;
+            }
+
+            if (!planner.collision().edgeFree(nearest->position, newPoint)) return nullptr;
+
+            Node* newNode = new Node(newPoint, nearest, nearest->cost + Metric::distance(nearest->position, newPoint));
+            tree.insert(newNode);
+            if (newPoint == target) return newNode;
+        }
+    }
+
+    Index goalTree;
+    bool swapped;
+    Node* startSide;
+    Node* goalSide;
+};
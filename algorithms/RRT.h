@@ -1,35 +1,29 @@
 #ifndef RRT_H
 #define RRT_H
 
-#include <SFML/Graphics.hpp>
-#include <vector>
-#include <cmath>
-#include <iostream>
-#include "utils.h"
+#include "Planner.h"
 
+typedef Planner<UniformSampler, LinearIndex<EuclideanMetric<2> >, AABBCollision, EuclideanMetric<2>, StepExtender> RRTBase;
 
-class RRT {
+// Same planner with another sampling policy, e.g. RRTSampled<BridgeSampler> or RRTSampled<AdaptiveSampler<> >
+template <class Sampler>
+using RRTSampled = Planner<Sampler, LinearIndex<EuclideanMetric<2> >, AABBCollision, EuclideanMetric<2>, StepExtender>;
+
+class RRT : public RRTBase {
 public:
-    RRT(sf::Vector2f start, sf::Vector2f goal, const std::vector<sf::RectangleShape>& obstacles, float stepSize = 10.0f);
+    RRT(sf::Vector2f start, sf::Vector2f goal, const std::vector<sf::RectangleShape>& obstacles, float stepSize = 10.0f)
+        : RRT(start, goal, AABBCollision(obstacles), stepSize) {}
 
-    bool run();
-    float getPathDistance() const;
-    std::vector<sf::Vector2f> getPath();
-    void drawPath(sf::RenderWindow& window) const;
-    void drawTree(sf::RenderWindow& window) const;
-private:
-    Node* nearestNode(sf::Vector2f point);
-    bool collisionFree(sf::Vector2f p1, sf::Vector2f p2) const;
-    float distance(sf::Vector2f p1, sf::Vector2f p2) const;
+    // polygons are convex obstacles, tested exactly like rotated rectangles
+    RRT(sf::Vector2f start, sf::Vector2f goal, const std::vector<sf::RectangleShape>& obstacles,
+        const std::vector<sf::ConvexShape>& polygons, float stepSize = 10.0f)
+        : RRT(start, goal, AABBCollision(obstacles, polygons), stepSize) {}
 
-    std::vector<Node*> tree;
-    std::vector<sf::Vector2f>* path;
-    sf::Vector2f start;
-    sf::Vector2f goal;
-    const std::vector<sf::RectangleShape>& obstacles;
-    float stepSize;
-    float pathLenght;
-    Node* goalNode;
+    // one checker, e.g. with the obstacles inflated by the robot footprint, shared between planners
+    RRT(sf::Vector2f start, sf::Vector2f goal, const AABBCollision& collision, float stepSize = 10.0f)
+        : RRTBase("RRT", sf::Color::Yellow, toVec2(start), toVec2(goal), collision, stepSize) {
+        setBounds(Vec2{0, 0}, Vec2{800, 600});
+    }
 };
 
 #endif // RRT_H
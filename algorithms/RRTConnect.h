@@ -1,35 +1,25 @@
 #ifndef RRT_CONNECT_H
 #define RRT_CONNECT_H
 
-#include <SFML/Graphics.hpp>
-#include <vector>
-#include <cmath>
-#include <iostream>
-#include "utils.h"
+#include "Planner.h"
 
-class RRTConnect {
-public:
-    RRTConnect(sf::Vector2f start, sf::Vector2f goal, const std::vector<sf::RectangleShape>& obstacles, float stepSize = 10.0f);
-
-    bool run();
-    std::vector<sf::Vector2f> getPath() const;
-    void drawPath(sf::RenderWindow& window) const;
+typedef Planner<UniformSampler, LinearIndex<EuclideanMetric<2> >, AABBCollision, EuclideanMetric<2>, ConnectExtender<LinearIndex<EuclideanMetric<2> > > > RRTConnectBase;
 
-private:
-    Node* nearestNode(const std::vector<Node*>& tree, sf::Vector2f point);
-    bool collisionFree(sf::Vector2f p1, sf::Vector2f p2) const;
-    float distance(sf::Vector2f p1, sf::Vector2f p2) const;
+class RRTConnect : public RRTConnectBase {
+public:
+    RRTConnect(sf::Vector2f start, sf::Vector2f goal, const std::vector<sf::RectangleShape>& obstacles, float stepSize = 10.0f)
+        : RRTConnect(start, goal, AABBCollision(obstacles), stepSize) {}
 
-    bool connect(std::vector<Node*>& tree, Node* node);
+    // polygons are convex obstacles, tested exactly like rotated rectangles
+    RRTConnect(sf::Vector2f start, sf::Vector2f goal, const std::vector<sf::RectangleShape>& obstacles,
+               const std::vector<sf::ConvexShape>& polygons, float stepSize = 10.0f)
+        : RRTConnect(start, goal, AABBCollision(obstacles, polygons), stepSize) {}
 
-    std::vector<Node*> treeStart;
-    std::vector<Node*> treeGoal;
-    sf::Vector2f start;
-    sf::Vector2f goal;
-    const std::vector<sf::RectangleShape>& obstacles;
-    float stepSize;
-    Node* connectionNodeStart;
-    Node* connectionNodeGoal;
+    // one checker, e.g. with the obstacles inflated by the robot footprint, shared between planners
+    RRTConnect(sf::Vector2f start, sf::Vector2f goal, const AABBCollision& collision, float stepSize = 10.0f)
+        : RRTConnectBase("RRTConnect", sf::Color(191, 0, 255), toVec2(start), toVec2(goal), collision, stepSize) {
+        setBounds(Vec2{0, 0}, Vec2{800, 600});
+    }
 };
 
 #endif // RRT_CONNECT_H
@@ -1,32 +1,22 @@
 #pragma once
 
-#include <SFML/Graphics.hpp>
-#include <vector>
-#include <cmath>
-#include <iostream>
-#include "utils.h"
+#include "Planner.h"
 
-class RRTOptimized {
+typedef Planner<GoalSampler, LinearIndex<EuclideanMetric<2> >, AABBCollision, RsqrtEuclideanMetric<2>, LocalSearchExtender> RRTOptimizedBase;
+
+class RRTOptimized : public RRTOptimizedBase {
 public:
-    RRTOptimized(sf::Vector2f start, sf::Vector2f goal, const std::vector<sf::RectangleShape>& obstacles, float stepSize = 10.0f);
+    RRTOptimized(sf::Vector2f start, sf::Vector2f goal, const std::vector<sf::RectangleShape>& obstacles, float stepSize = 10.0f)
+        : RRTOptimized(start, goal, AABBCollision(obstacles), stepSize) {}
 
-    bool run();
-    float getPathDistance() const;
-    std::vector<sf::Vector2f> getPath();
-    void drawPath(sf::RenderWindow& window) const;
-    void drawTree(sf::RenderWindow& window) const;
-private:
-    Node* nearestNode(sf::Vector2f point);
-    bool collisionFree(sf::Vector2f p1, sf::Vector2f p2) const;
-    float distance2(sf::Vector2f p1, sf::Vector2f p2) const;
+    // polygons are convex obstacles, tested exactly like rotated rectangles
+    RRTOptimized(sf::Vector2f start, sf::Vector2f goal, const std::vector<sf::RectangleShape>& obstacles,
+                 const std::vector<sf::ConvexShape>& polygons, float stepSize = 10.0f)
+        : RRTOptimized(start, goal, AABBCollision(obstacles, polygons), stepSize) {}
 
-    std::vector<Node*> tree;
-    std::vector<sf::Vector2f>* path;
-    sf::Vector2f start;
-    sf::Vector2f goal;
-    const std::vector<sf::RectangleShape>& obstacles;
-    float stepSize;
-    float pathLenght;
-    Node* goalNode;
+    // one checker, e.g. with the obstacles inflated by the robot footprint, shared between planners
+    RRTOptimized(sf::Vector2f start, sf::Vector2f goal, const AABBCollision& collision, float stepSize = 10.0f)
+        : RRTOptimizedBase("RRTOptimized", sf::Color::Red, toVec2(start), toVec2(goal), collision, stepSize) {
+        setBounds(Vec2{0, 0}, Vec2{800, 600});
+    }
 };
-
@@ -1,34 +1,29 @@
 #ifndef RRT_STAR_H
 #define RRT_STAR_H
 
-#include <SFML/Graphics.hpp>
-#include <vector>
-#include <cmath>
-#include <iostream>
-#include <algorithm>
-#include "utils.h"
+#include "Planner.h"
 
-class RRTStar {
-public:
-    RRTStar(sf::Vector2f start, sf::Vector2f goal, const std::vector<sf::RectangleShape>& obstacles, float stepSize = 10.0f, float radius = 50.0f);
+typedef Planner<UniformSampler, LinearIndex<EuclideanMetric<2> >, AABBCollision, EuclideanMetric<2>, RewireExtender<LinearIndex<EuclideanMetric<2> > > > RRTStarBase;
+
+// Same planner with another sampling policy, e.g. RRTStarSampled<BridgeSampler> or RRTStarSampled<AdaptiveSampler<> >
+template <class Sampler>
+using RRTStarSampled = Planner<Sampler, LinearIndex<EuclideanMetric<2> >, AABBCollision, EuclideanMetric<2>, RewireExtender<LinearIndex<EuclideanMetric<2> > >>;
 
-    bool run();
-    std::vector<sf::Vector2f> getPath() const;
-    void drawPath(sf::RenderWindow& window) const;
+class RRTStar : public RRTStarBase {
+public:
+    RRTStar(sf::Vector2f start, sf::Vector2f goal, const std::vector<sf::RectangleShape>& obstacles, float stepSize = 10.0f, float radius = 50.0f)
+        : RRTStar(start, goal, AABBCollision(obstacles), stepSize, radius) {}
 
-private:
-    Node* nearestNode(sf::Vector2f point);
-    std::vector<Node*> nearNodes(sf::Vector2f point, float radius);
-    bool collisionFree(sf::Vector2f p1, sf::Vector2f p2) const;
-    float distance(sf::Vector2f p1, sf::Vector2f p2) const;
+    // polygons are convex obstacles, tested exactly like rotated rectangles
+    RRTStar(sf::Vector2f start, sf::Vector2f goal, const std::vector<sf::RectangleShape>& obstacles,
+            const std::vector<sf::ConvexShape>& polygons, float stepSize = 10.0f, float radius = 50.0f)
+        : RRTStar(start, goal, AABBCollision(obstacles, polygons), stepSize, radius) {}
 
-    std::vector<Node*> tree;
-    sf::Vector2f start;
-    sf::Vector2f goal;
-    const std::vector<sf::RectangleShape>& obstacles;
-    float stepSize;
-    float radius;
-    Node* goalNode;
+    // one checker, e.g. with the obstacles inflated by the robot footprint, shared between planners
+    RRTStar(sf::Vector2f start, sf::Vector2f goal, const AABBCollision& collision, float stepSize = 10.0f, float radius = 50.0f)
+        : RRTStarBase("RRTStar", sf::Color::Green, toVec2(start), toVec2(goal), collision, stepSize, radius) {
+        setBounds(Vec2{0, 0}, Vec2{800, 600});
+    }
 };
 
 #endif // RRT_STAR_H
@@ -0,0 +1,133 @@
+#include "Scenario.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+const char MAGIC[4] = {'P', 'P', 'S', 'C'};
+
+bool hostIsLittleEndian() {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const uint8_t*>(&probe) == 1;
+}
+
+uint64_t align16(uint64_t offset) {
+    return (offset + 15) & ~static_cast<uint64_t>(15);
+}
+
+// [offset, offset + count * size) lies inside the file and is 16-byte aligned
+bool sectionFits(uint64_t offset, uint64_t count, uint64_t size, uint64_t fileSize) {
+    if (offset % 16 != 0 || offset > fileSize) return false;
+    return count <= (fileSize - offset) / size;
+}
+
+} // namespace
+
+Scenario::Scenario()
+    : mapping(nullptr), mappingSize(0), header(nullptr), obstacleData(nullptr), queryData(nullptr) {}
+
+Scenario::~Scenario() {
+    close();
+}
+
+void Scenario::close() {
+    if (mapping) munmap(mapping, mappingSize);
+    mapping = nullptr;
+    mappingSize = 0;
+    header = nullptr;
+    obstacleData = nullptr;
+    queryData = nullptr;
+}
+
+void Scenario::prefetch() const {
+    if (mapping) madvise(mapping, mappingSize, MADV_WILLNEED);
+}
+
+bool Scenario::load(const std::string& path) {
+    close();
+
+    if (!hostIsLittleEndian()) {
+        std::cerr << "Scenario: zero-copy loading needs a little-endian host\n";
+        return false;
+    }
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Scenario: cannot open " << path << "\n";
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(ScenarioHeader)) {
+        std::cerr << "Scenario: " << path << " is too small\n";
+        ::close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        std::cerr << "Scenario: mmap failed for " << path << "\n";
+        return false;
+    }
+    mapping = data;
+    mappingSize = info.st_size;
+
+    const ScenarioHeader* h = static_cast<const ScenarioHeader*>(data);
+    if (std::memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0 || h->version != VERSION) {
+        std::cerr << "Scenario: " << path << " is not a version " << VERSION << " scenario\n";
+        close();
+        return false;
+    }
+    if (!sectionFits(h->obstacleOffset, h->obstacleCount, sizeof(ObstacleRect), mappingSize) ||
+        !sectionFits(h->queryOffset, h->queryCount, sizeof(ScenarioQuery), mappingSize)) {
+        std::cerr << "Scenario: " << path << " is truncated\n";
+        close();
+        return false;
+    }
+
+    const char* bytes = static_cast<const char*>(data);
+    header = h;
+    obstacleData = reinterpret_cast<const ObstacleRect*>(bytes + h->obstacleOffset);
+    queryData = reinterpret_cast<const ScenarioQuery*>(bytes + h->queryOffset);
+    return true;
+}
+
+bool Scenario::save(const std::string& path, float worldMinX, float worldMinY, float worldMaxX, float worldMaxY,
+                    const std::vector<ObstacleRect>& obstacles, const std::vector<ScenarioQuery>& queries) {
+    if (!hostIsLittleEndian()) {
+        std::cerr << "Scenario: writing needs a little-endian host\n";
+        return false;
+    }
+
+    ScenarioHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = VERSION;
+    h.worldMinX = worldMinX;
+    h.worldMinY = worldMinY;
+    h.worldMaxX = worldMaxX;
+    h.worldMaxY = worldMaxY;
+    h.obstacleCount = obstacles.size();
+    h.obstacleOffset = align16(sizeof(ScenarioHeader));
+    h.queryCount = queries.size();
+    h.queryOffset = align16(h.obstacleOffset + obstacles.size() * sizeof(ObstacleRect));
+
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Scenario: cannot write " << path << "\n";
+        return false;
+    }
+
+    // both sections are already 16-byte multiples, so no padding is written between them
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(reinterpret_cast<const char*>(obstacles.data()), obstacles.size() * sizeof(ObstacleRect));
+    out.write(reinterpret_cast<const char*>(queries.data()), queries.size() * sizeof(ScenarioQuery));
+    return static_cast<bool>(out);
+}
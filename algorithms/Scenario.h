@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Obstacles.h"
+
+////////////////////////////////////////////////////
+//
+// Binary scenario file, little-endian, version 1:
+//
+//   ScenarioHeader                     64 bytes
+//   ObstacleRect[obstacleCount]        at obstacleOffset (16-byte aligned)
+//   ScenarioQuery[queryCount]          at queryOffset    (16-byte aligned)
+//
+// The file is mapped read-only with mmap and the obstacle array is handed
+// to the collision backend in place, so loading costs no parsing or copies.
+//
+////////////////////////////////////////////////////
+
+struct ScenarioQuery {
+    float startX, startY;
+    float goalX, goalY;
+};
+
+struct ScenarioHeader {
+    char magic[4];              // "PPSC"
+    uint32_t version;
+    float worldMinX, worldMinY;
+    float worldMaxX, worldMaxY;
+    uint64_t obstacleCount;
+    uint64_t obstacleOffset;
+    uint64_t queryCount;
+    uint64_t queryOffset;
+    uint8_t reserved[8];
+};
+
+static_assert(sizeof(ObstacleRect) == 16, "ObstacleRect is part of the file format");
+static_assert(sizeof(ScenarioQuery) == 16, "ScenarioQuery is part of the file format");
+static_assert(sizeof(ScenarioHeader) == 64, "ScenarioHeader is part of the file format");
+
+class Scenario {
+public:
+    static const uint32_t VERSION = 1;
+
+    Scenario();
+    ~Scenario();
+    Scenario(const Scenario&) = delete;
+    Scenario& operator=(const Scenario&) = delete;
+
+    // maps the file; on failure prints the reason to std::cerr and returns false
+    bool load(const std::string& path);
+    void close();
+
+    // asks the kernel to start reading the whole mapping in the background
+    void prefetch() const;
+
+    static bool save(const std::string& path, float worldMinX, float worldMinY, float worldMaxX, float worldMaxY,
+                     const std::vector<ObstacleRect>& obstacles, const std::vector<ScenarioQuery>& queries);
+
+    bool isLoaded() const { return header != nullptr; }
+    const ScenarioHeader& getHeader() const { return *header; }
+
+    // point into the mapping, valid until close()
+    const ObstacleRect* obstacles() const { return obstacleData; }
+    size_t obstacleCount() const { return header ? static_cast<size_t>(header->obstacleCount) : 0; }
+    const ScenarioQuery* queries() const { return queryData; }
+    size_t queryCount() const { return header ? static_cast<size_t>(header->queryCount) : 0; }
+
+private:
+    void* mapping;
+    size_t mappingSize;
+    const ScenarioHeader* header;
+    const ObstacleRect* obstacleData;
+    const ScenarioQuery* queryData;
+};
@@ -0,0 +1,475 @@
+#include "Steering.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace {
+
+const float PI = 3.14159265358979f;
+const float TWO_PI = 2.0f * PI;
+const float ZERO = 10 * std::numeric_limits<float>::epsilon();
+
+// [0, 2pi)
+float mod2pi(float x) {
+    float v = std::fmod(x, TWO_PI);
+    return v < 0 ? v + TWO_PI : v;
+}
+
+void polar(float x, float y, float& r, float& theta) {
+    r = std::sqrt(x * x + y * y);
+    theta = std::atan2(y, x);
+}
+
+// (dx, dy, dtheta) of `to` in the frame of `from`, scaled by 1 / turningRadius
+void relativePose(const Pose& from, const Pose& to, float turningRadius, float& x, float& y, float& phi) {
+    float dx = to[0] - from[0];
+    float dy = to[1] - from[1];
+    float c = std::cos(from[2]), s = std::sin(from[2]);
+    x = (c * dx + s * dy) / turningRadius;
+    y = (-s * dx + c * dy) / turningRadius;
+    phi = to[2] - from[2];
+}
+
+void keepShortest(CurvePath& best, float& bestLength, const CurvePath& candidate) {
+    float length = candidate.length();
+    if (length < bestLength) {
+        best = candidate;
+        bestLength = length;
+    }
+}
+
+
+// ---------------- Dubins ----------------
+// d, alpha, beta as in Shkel & Lumelsky, "Classification of the Dubins set"
+
+void dubinsWords(float d, float alpha, float beta, CurvePath& best, float& bestLength) {
+    const float ca = std::cos(alpha), sa = std::sin(alpha);
+    const float cb = std::cos(beta), sb = std::sin(beta);
+    const float cab = ca * cb + sa * sb;
+    float tmp, theta, p;
+
+    // LSL
+    tmp = 2 + d * d - 2 * (cab - d * (sa - sb));
+    if (tmp >= ZERO) {
+        theta = std::atan2(cb - ca, d + sa - sb);
+        keepShortest(best, bestLength, CurvePath(CurvePath::LEFT, CurvePath::STRAIGHT, CurvePath::LEFT,
+                                                 mod2pi(-alpha + theta), std::sqrt(std::max(tmp, 0.0f)), mod2pi(beta - theta)));
+    }
+
+    // RSR
+    tmp = 2 + d * d - 2 * (cab - d * (sb - sa));
+    if (tmp >= ZERO) {
+        theta = std::atan2(ca - cb, d - sa + sb);
+        keepShortest(best, bestLength, CurvePath(CurvePath::RIGHT, CurvePath::STRAIGHT, CurvePath::RIGHT,
+                                                 mod2pi(alpha - theta), std::sqrt(std::max(tmp, 0.0f)), mod2pi(-beta + theta)));
+    }
+
+    // RSL
+    tmp = d * d - 2 + 2 * (cab - d * (sa + sb));
+    if (tmp >= ZERO) {
+        p = std::sqrt(std::max(tmp, 0.0f));
+        theta = std::atan2(ca + cb, d - sa - sb) - std::atan2(2.0f, p);
+        keepShortest(best, bestLength, CurvePath(CurvePath::RIGHT, CurvePath::STRAIGHT, CurvePath::LEFT,
+                                                 mod2pi(alpha - theta), p, mod2pi(beta - theta)));
+    }
+
+    // LSR
+    tmp = -2 + d * d + 2 * (cab + d * (sa + sb));
+    if (tmp >= ZERO) {
+        p = std::sqrt(std::max(tmp, 0.0f));
+        theta = std::atan2(-ca - cb, d + sa + sb) - std::atan2(-2.0f, p);
+        keepShortest(best, bestLength, CurvePath(CurvePath::LEFT, CurvePath::STRAIGHT, CurvePath::RIGHT,
+                                                 mod2pi(-alpha + theta), p, mod2pi(-beta + theta)));
+    }
+
+    // RLR
+    tmp = 0.125f * (6 - d * d + 2 * (cab + d * (sa - sb)));
+    if (std::fabs(tmp) < 1) {
+        p = TWO_PI - std::acos(tmp);
+        theta = std::atan2(ca - cb, d - sa + sb);
+        float t = mod2pi(alpha - theta + 0.5f * p);
+        keepShortest(best, bestLength, CurvePath(CurvePath::RIGHT, CurvePath::LEFT, CurvePath::RIGHT,
+                                                 t, p, mod2pi(alpha - beta - t + p)));
+    }
+
+    // LRL
+    tmp = 0.125f * (6 - d * d + 2 * (cab - d * (sa - sb)));
+    if (std::fabs(tmp) < 1) {
+        p = TWO_PI - std::acos(tmp);
+        theta = std::atan2(-ca + cb, d + sa - sb);
+        float t = mod2pi(-alpha + theta + 0.5f * p);
+        keepShortest(best, bestLength, CurvePath(CurvePath::LEFT, CurvePath::RIGHT, CurvePath::LEFT,
+                                                 t, p, mod2pi(beta - alpha - t + p)));
+    }
+}
+
+
+// ---------------- Reeds-Shepp ----------------
+// Formulas 8.1 - 8.11 of Reeds & Shepp, "Optimal paths for a car that goes both forwards and backwards",
+// with the corrections OMPL applies to the typos in 8.4 and 8.11
+
+// (-pi, pi]
+float mod2piSigned(float x) {
+    return wrapAngle(x);
+}
+
+bool LpSpLp(float x, float y, float phi, float& t, float& u, float& v) {
+    polar(x - std::sin(phi), y - 1 + std::cos(phi), u, t);
+    if (t >= -ZERO) {
+        v = mod2piSigned(phi - t);
+        if (v >= -ZERO) return true;
+    }
+    return false;
+}
+
+bool LpSpRp(float x, float y, float phi, float& t, float& u, float& v) {
+    float t1, u1;
+    polar(x + std::sin(phi), y - 1 - std::cos(phi), u1, t1);
+    u1 = u1 * u1;
+    if (u1 >= 4) {
+        u = std::sqrt(u1 - 4);
+        float theta = std::atan2(2.0f, u);
+        t = mod2piSigned(t1 + theta);
+        v = mod2piSigned(t - phi);
+        return t >= -ZERO && v >= -ZERO;
+    }
+    return false;
+}
+
+bool LpRmL(float x, float y, float phi, float& t, float& u, float& v) {
+    float u1, theta;
+    polar(x - std::sin(phi), y - 1 + std::cos(phi), u1, theta);
+    if (u1 <= 4) {
+        u = -2 * std::asin(0.25f * u1);
+        t = mod2piSigned(theta + 0.5f * u + PI);
+        v = mod2piSigned(phi - t + u);
+        return t >= -ZERO && u <= ZERO;
+    }
+    return false;
+}
+
+void tauOmega(float u, float v, float xi, float eta, float phi, float& tau, float& omega) {
+    const float delta = mod2piSigned(u - v);
+    const float a = std::sin(u) - std::sin(delta), b = std::cos(u) - std::cos(delta) - 1;
+    const float t1 = std::atan2(eta * a - xi * b, xi * a + eta * b);
+    const float t2 = 2 * (std::cos(delta) - std::cos(v) - std::cos(u)) + 3;
+    tau = (t2 < 0) ? mod2piSigned(t1 + PI) : mod2piSigned(t1);
+    omega = mod2piSigned(tau - u + v - phi);
+}
+
+// 8.7
+bool LpRupLumRm(float x, float y, float phi, float& t, float& u, float& v) {
+    const float xi = x + std::sin(phi), eta = y - 1 - std::cos(phi);
+    const float rho = 0.25f * (2 + std::sqrt(xi * xi + eta * eta));
+    if (rho <= 1) {
+        u = std::acos(rho);
+        tauOmega(u, -u, xi, eta, phi, t, v);
+        return t >= -ZERO && v <= ZERO;
+    }
+    return false;
+}
+
+// 8.8
+bool LpRumLumRp(float x, float y, float phi, float& t, float& u, float& v) {
+    const float xi = x + std::sin(phi), eta = y - 1 - std::cos(phi);
+    const float rho = (20 - xi * xi - eta * eta) / 16;
+    if (rho >= 0 && rho <= 1) {
+        u = -std::acos(rho);
+        if (u >= -0.5f * PI) {
+            tauOmega(u, u, xi, eta, phi, t, v);
+            return t >= -ZERO && v >= -ZERO;
+        }
+    }
+    return false;
+}
+
+// 8.9
+bool LpRmSmLm(float x, float y, float phi, float& t, float& u, float& v) {
+    float rho, theta;
+    polar(x - std::sin(phi), y - 1 + std::cos(phi), rho, theta);
+    if (rho >= 2) {
+        const float r = std::sqrt(rho * rho - 4);
+        u = 2 - r;
+        t = mod2piSigned(theta + std::atan2(r, -2.0f));
+        v = mod2piSigned(phi - 0.5f * PI - t);
+        return t >= -ZERO && u <= ZERO && v <= ZERO;
+    }
+    return false;
+}
+
+// 8.10
+bool LpRmSmRm(float x, float y, float phi, float& t, float& u, float& v) {
+    const float xi = x + std::sin(phi), eta = y - 1 - std::cos(phi);
+    float rho, theta;
+    polar(-eta, xi, rho, theta);
+    if (rho >= 2) {
+        t = theta;
+        u = 2 - rho;
+        v = mod2piSigned(t + 0.5f * PI - phi);
+        return t >= -ZERO && u <= ZERO && v <= ZERO;
+    }
+    return false;
+}
+
+// 8.11
+bool LpRmSLmRp(float x, float y, float phi, float& t, float& u, float& v) {
+    const float xi = x + std::sin(phi), eta = y - 1 - std::cos(phi);
+    float rho, theta;
+    polar(xi, eta, rho, theta);
+    if (rho >= 2) {
+        u = 4 - std::sqrt(rho * rho - 4);
+        if (u <= ZERO) {
+            t = mod2piSigned(std::atan2((4 - u) * xi - 2 * eta, -2 * xi + (u - 4) * eta));
+            v = mod2piSigned(t - phi);
+            return t >= -ZERO && v >= -ZERO;
+        }
+    }
+    return false;
+}
+
+void reedsSheppCSC(float x, float y, float phi, CurvePath& best, float& bestLength) {
+    const CurvePath::Segment L = CurvePath::LEFT, S = CurvePath::STRAIGHT, R = CurvePath::RIGHT;
+    float t, u, v;
+    if (LpSpLp(x, y, phi, t, u, v))    keepShortest(best, bestLength, CurvePath(L, S, L, t, u, v));
+    if (LpSpLp(-x, y, -phi, t, u, v))  keepShortest(best, bestLength, CurvePath(L, S, L, -t, -u, -v)); // timeflip
+    if (LpSpLp(x, -y, -phi, t, u, v))  keepShortest(best, bestLength, CurvePath(R, S, R, t, u, v));    // reflect
+    if (LpSpLp(-x, -y, phi, t, u, v))  keepShortest(best, bestLength, CurvePath(R, S, R, -t, -u, -v)); // timeflip + reflect
+    if (LpSpRp(x, y, phi, t, u, v))    keepShortest(best, bestLength, CurvePath(L, S, R, t, u, v));
+    if (LpSpRp(-x, y, -phi, t, u, v))  keepShortest(best, bestLength, CurvePath(L, S, R, -t, -u, -v));
+    if (LpSpRp(x, -y, -phi, t, u, v))  keepShortest(best, bestLength, CurvePath(R, S, L, t, u, v));
+    if (LpSpRp(-x, -y, phi, t, u, v))  keepShortest(best, bestLength, CurvePath(R, S, L, -t, -u, -v));
+}
+
+void reedsSheppCCC(float x, float y, float phi, CurvePath& best, float& bestLength) {
+    const CurvePath::Segment L = CurvePath::LEFT, R = CurvePath::RIGHT;
+    float t, u, v;
+    if (LpRmL(x, y, phi, t, u, v))     keepShortest(best, bestLength, CurvePath(L, R, L, t, u, v));
+    if (LpRmL(-x, y, -phi, t, u, v))   keepShortest(best, bestLength, CurvePath(L, R, L, -t, -u, -v));
+    if (LpRmL(x, -y, -phi, t, u, v))   keepShortest(best, bestLength, CurvePath(R, L, R, t, u, v));
+    if (LpRmL(-x, -y, phi, t, u, v))   keepShortest(best, bestLength, CurvePath(R, L, R, -t, -u, -v));
+
+    // backwards
+    float xb = x * std::cos(phi) + y * std::sin(phi);
+    float yb = x * std::sin(phi) - y * std::cos(phi);
+    if (LpRmL(xb, yb, phi, t, u, v))   keepShortest(best, bestLength, CurvePath(L, R, L, v, u, t));
+    if (LpRmL(-xb, yb, -phi, t, u, v)) keepShortest(best, bestLength, CurvePath(L, R, L, -v, -u, -t));
+    if (LpRmL(xb, -yb, -phi, t, u, v)) keepShortest(best, bestLength, CurvePath(R, L, R, v, u, t));
+    if (LpRmL(-xb, -yb, phi, t, u, v)) keepShortest(best, bestLength, CurvePath(R, L, R, -v, -u, -t));
+}
+
+void reedsSheppCCCC(float x, float y, float phi, CurvePath& best, float& bestLength) {
+    const CurvePath::Segment L = CurvePath::LEFT, R = CurvePath::RIGHT;
+    float t, u, v;
+    if (LpRupLumRm(x, y, phi, t, u, v))    keepShortest(best, bestLength, CurvePath(L, R, L, R, t, u, -u, v));
+    if (LpRupLumRm(-x, y, -phi, t, u, v))  keepShortest(best, bestLength, CurvePath(L, R, L, R, -t, -u, u, -v));
+    if (LpRupLumRm(x, -y, -phi, t, u, v))  keepShortest(best, bestLength, CurvePath(R, L, R, L, t, u, -u, v));
+    if (LpRupLumRm(-x, -y, phi, t, u, v))  keepShortest(best, bestLength, CurvePath(R, L, R, L, -t, -u, u, -v));
+
+    if (LpRumLumRp(x, y, phi, t, u, v))    keepShortest(best, bestLength, CurvePath(L, R, L, R, t, u, u, v));
+    if (LpRumLumRp(-x, y, -phi, t, u, v))  keepShortest(best, bestLength, CurvePath(L, R, L, R, -t, -u, -u, -v));
+    if (LpRumLumRp(x, -y, -phi, t, u, v))  keepShortest(best, bestLength, CurvePath(R, L, R, L, t, u, u, v));
+    if (LpRumLumRp(-x, -y, phi, t, u, v))  keepShortest(best, bestLength, CurvePath(R, L, R, L, -t, -u, -u, -v));
+}
+
+void reedsSheppCCSC(float x, float y, float phi, CurvePath& best, float& bestLength) {
+    const CurvePath::Segment L = CurvePath::LEFT, S = CurvePath::STRAIGHT, R = CurvePath::RIGHT;
+    const float quarter = 0.5f * PI;
+    float t, u, v;
+    if (LpRmSmLm(x, y, phi, t, u, v))      keepShortest(best, bestLength, CurvePath(L, R, S, L, t, -quarter, u, v));
+    if (LpRmSmLm(-x, y, -phi, t, u, v))    keepShortest(best, bestLength, CurvePath(L, R, S, L, -t, quarter, -u, -v));
+    if (LpRmSmLm(x, -y, -phi, t, u, v))    keepShortest(best, bestLength, CurvePath(R, L, S, R, t, -quarter, u, v));
+    if (LpRmSmLm(-x, -y, phi, t, u, v))    keepShortest(best, bestLength, CurvePath(R, L, S, R, -t, quarter, -u, -v));
+
+    if (LpRmSmRm(x, y, phi, t, u, v))      keepShortest(best, bestLength, CurvePath(L, R, S, R, t, -quarter, u, v));
+    if (LpRmSmRm(-x, y, -phi, t, u, v))    keepShortest(best, bestLength, CurvePath(L, R, S, R, -t, quarter, -u, -v));
+    if (LpRmSmRm(x, -y, -phi, t, u, v))    keepShortest(best, bestLength, CurvePath(R, L, S, L, t, -quarter, u, v));
+    if (LpRmSmRm(-x, -y, phi, t, u, v))    keepShortest(best, bestLength, CurvePath(R, L, S, L, -t, quarter, -u, -v));
+
+    // backwards
+    const float xb = x * std::cos(phi) + y * std::sin(phi);
+    const float yb = x * std::sin(phi) - y * std::cos(phi);
+    if (LpRmSmLm(xb, yb, phi, t, u, v))    keepShortest(best, bestLength, CurvePath(L, S, R, L, v, u, -quarter, t));
+    if (LpRmSmLm(-xb, yb, -phi, t, u, v))  keepShortest(best, bestLength, CurvePath(L, S, R, L, -v, -u, quarter, -t));
+    if (LpRmSmLm(xb, -yb, -phi, t, u, v))  keepShortest(best, bestLength, CurvePath(R, S, L, R, v, u, -quarter, t));
+    if (LpRmSmLm(-xb, -yb, phi, t, u, v))  keepShortest(best, bestLength, CurvePath(R, S, L, R, -v, -u, quarter, -t));
+
+    if (LpRmSmRm(xb, yb, phi, t, u, v))    keepShortest(best, bestLength, CurvePath(R, S, R, L, v, u, -quarter, t));
+    if (LpRmSmRm(-xb, yb, -phi, t, u, v))  keepShortest(best, bestLength, CurvePath(R, S, R, L, -v, -u, quarter, -t));
+    if (LpRmSmRm(xb, -yb, -phi, t, u, v))  keepShortest(best, bestLength, CurvePath(L, S, L, R, v, u, -quarter, t));
+    if (LpRmSmRm(-xb, -yb, phi, t, u, v))  keepShortest(best, bestLength, CurvePath(L, S, L, R, -v, -u, quarter, -t));
+}
+
+void reedsSheppCCSCC(float x, float y, float phi, CurvePath& best, float& bestLength) {
+    const CurvePath::Segment L = CurvePath::LEFT, S = CurvePath::STRAIGHT, R = CurvePath::RIGHT;
+    const float quarter = 0.5f * PI;
+    float t, u, v;
+    if (LpRmSLmRp(x, y, phi, t, u, v))     keepShortest(best, bestLength, CurvePath(L, R, S, L, R, t, -quarter, u, -quarter, v));
+    if (LpRmSLmRp(-x, y, -phi, t, u, v))   keepShortest(best, bestLength, CurvePath(L, R, S, L, R, -t, quarter, -u, quarter, -v));
+    if (LpRmSLmRp(x, -y, -phi, t, u, v))   keepShortest(best, bestLength, CurvePath(R, L, S, R, L, t, -quarter, u, -quarter, v));
+    if (LpRmSLmRp(-x, -y, phi, t, u, v))   keepShortest(best, bestLength, CurvePath(R, L, S, R, L, -t, quarter, -u, quarter, -v));
+}
+
+} // namespace
+
+
+float wrapAngle(float angle) {
+    float v = std::fmod(angle, TWO_PI);
+    if (v <= -PI) v += TWO_PI;
+    else if (v > PI) v -= TWO_PI;
+    return v;
+}
+
+CurvePath::CurvePath() {
+    for (int i = 0; i < 5; ++i) {
+        types[i] = NONE;
+        lengths[i] = 0.0f;
+    }
+}
+
+CurvePath::CurvePath(Segment a, Segment b, Segment c, float t, float u, float v)
+    : CurvePath(a, b, c, NONE, NONE, t, u, v, 0.0f, 0.0f) {}
+
+CurvePath::CurvePath(Segment a, Segment b, Segment c, Segment d, float t, float u, float v, float w)
+    : CurvePath(a, b, c, d, NONE, t, u, v, w, 0.0f) {}
+
+CurvePath::CurvePath(Segment a, Segment b, Segment c, Segment d, Segment e, float t, float u, float v, float w, float z) {
+    const Segment segments[5] = {a, b, c, d, e};
+    const float segmentLengths[5] = {t, u, v, w, z};
+    for (int i = 0; i < 5; ++i) {
+        types[i] = segments[i];
+        lengths[i] = segmentLengths[i];
+    }
+}
+
+float CurvePath::length() const {
+    float sum = 0.0f;
+    for (int i = 0; i < 5; ++i) sum += std::fabs(lengths[i]);
+    return sum;
+}
+
+CurvePath DubinsCurve::shortest(const Pose& from, const Pose& to, float turningRadius) {
+    float dx = to[0] - from[0];
+    float dy = to[1] - from[1];
+    float d = std::sqrt(dx * dx + dy * dy) / turningRadius;
+    float th = (d > ZERO) ? mod2pi(std::atan2(dy, dx)) : 0.0f;
+    float alpha = mod2pi(from[2] - th);
+    float beta = mod2pi(to[2] - th);
+
+    CurvePath best;
+    float bestLength = std::numeric_limits<float>::max();
+    dubinsWords(d, alpha, beta, best, bestLength);
+    return best;
+}
+
+CurvePath ReedsSheppCurve::shortest(const Pose& from, const Pose& to, float turningRadius) {
+    float x, y, phi;
+    relativePose(from, to, turningRadius, x, y, phi);
+
+    CurvePath best;
+    float bestLength = std::numeric_limits<float>::max();
+    reedsSheppCSC(x, y, phi, best, bestLength);
+    reedsSheppCCC(x, y, phi, best, bestLength);
+    reedsSheppCCCC(x, y, phi, best, bestLength);
+    reedsSheppCCSC(x, y, phi, best, bestLength);
+    reedsSheppCCSCC(x, y, phi, best, bestLength);
+    // the families cover every pose; float rounding right at their boundaries could still leave none
+    return best.valid() ? best : DubinsCurve::shortest(from, to, turningRadius);
+}
+
+Pose interpolateCurve(const Pose& from, const CurvePath& path, float turningRadius, float distance) {
+    // walk the segments in the normalized frame (unit turning radius)
+    float remaining = distance / turningRadius;
+    float x = 0.0f, y = 0.0f, phi = from[2];
+
+    for (int i = 0; i < 5 && remaining > 0.0f && path.types[i] != CurvePath::NONE; ++i) {
+        float v = path.lengths[i];
+        if (std::fabs(v) > remaining) {
+            v = (v < 0) ? -remaining : remaining;
+        }
+        remaining -= std::fabs(v);
+
+        switch (path.types[i]) {
+        case CurvePath::LEFT:
+            x += std::sin(phi + v) - std::sin(phi);
+            y += -std::cos(phi + v) + std::cos(phi);
+            phi += v;
+            break;
+        case CurvePath::RIGHT:
+            x += -std::sin(phi - v) + std::sin(phi);
+            y += std::cos(phi - v) - std::cos(phi);
+            phi -= v;
+            break;
+        case CurvePath::STRAIGHT:
+            x += v * std::cos(phi);
+            y += v * std::sin(phi);
+            break;
+        case CurvePath::NONE:
+            break;
+        }
+    }
+
+    return Pose{from[0] + x * turningRadius, from[1] + y * turningRadius, wrapAngle(phi)};
+}
+
+
+SteeringTable::SteeringTable(Shortest shortest, float turningRadius, float range, size_t maxBytes)
+    : shortest(shortest), turningRadius(turningRadius), range(range) {
+    // n * n * n cells of one float each, at least two samples per axis
+    n = std::max(2, static_cast<int>(std::cbrt(static_cast<double>(maxBytes / sizeof(float)))));
+    nTheta = n;
+    spacing = 2.0f * range / (n - 1);
+    thetaSpacing = TWO_PI / nTheta;
+
+    cells.resize(static_cast<size_t>(n) * n * nTheta);
+    const Pose origin{0.0f, 0.0f, 0.0f};
+    for (int it = 0; it < nTheta; ++it) {
+        for (int iy = 0; iy < n; ++iy) {
+            for (int ix = 0; ix < n; ++ix) {
+                Pose to{-range + ix * spacing, -range + iy * spacing, it * thetaSpacing};
+                cells[(static_cast<size_t>(it) * n + iy) * n + ix] = shortest(origin, to, turningRadius).length() * turningRadius;
+            }
+        }
+    }
+}
+
+float SteeringTable::exactDistance(const Pose& from, const Pose& to) const {
+    CurvePath path = shortest(from, to, turningRadius);
+    return path.valid() ? path.length() * turningRadius : std::numeric_limits<float>::max();
+}
+
+float SteeringTable::distance(const Pose& from, const Pose& to) const {
+    float x, y, phi;
+    relativePose(from, to, 1.0f, x, y, phi);
+    if (std::fabs(x) >= range || std::fabs(y) >= range) {
+        return exactDistance(from, to);
+    }
+
+    // trilinear interpolation, the heading axis wraps around
+    float fx = (x + range) / spacing;
+    float fy = (y + range) / spacing;
+    float ft = mod2pi(phi) / thetaSpacing;
+    int ix = std::min(static_cast<int>(fx), n - 2);
+    int iy = std::min(static_cast<int>(fy), n - 2);
+    int it = std::min(static_cast<int>(ft), nTheta - 1);
+    int it1 = (it + 1) % nTheta;
+    fx -= ix;
+    fy -= iy;
+    ft -= it;
+
+    float c00 = cell(ix, iy, it) * (1 - fx) + cell(ix + 1, iy, it) * fx;
+    float c10 = cell(ix, iy + 1, it) * (1 - fx) + cell(ix + 1, iy + 1, it) * fx;
+    float c01 = cell(ix, iy, it1) * (1 - fx) + cell(ix + 1, iy, it1) * fx;
+    float c11 = cell(ix, iy + 1, it1) * (1 - fx) + cell(ix + 1, iy + 1, it1) * fx;
+    float c0 = c00 * (1 - fy) + c10 * fy;
+    float c1 = c01 * (1 - fy) + c11 * fy;
+    return c0 * (1 - ft) + c1 * ft;
+}
+
+
+// The ready-made car planners are only templates; instantiating them here keeps them compiled
+// with the rest of the tree
+template class Planner<UniformSampler, LinearIndex<DubinsMetric>, CurveCollision<DubinsCurve>, DubinsMetric, GoalConnectExtender<StepExtender> >;
+template class Planner<UniformSampler, LinearIndex<DubinsMetric>, CurveCollision<DubinsCurve>, DubinsMetric, GoalConnectExtender<RewireExtender<LinearIndex<DubinsMetric> > > >;
+template class Planner<UniformSampler, LinearIndex<ReedsSheppMetric>, CurveCollision<ReedsSheppCurve>, ReedsSheppMetric, GoalConnectExtender<StepExtender> >;
+template class Planner<UniformSampler, LinearIndex<ReedsSheppMetric>, CurveCollision<ReedsSheppCurve>, ReedsSheppMetric, GoalConnectExtender<RewireExtender<LinearIndex<ReedsSheppMetric> > > >;
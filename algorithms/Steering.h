@@ -0,0 +1,257 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <iostream>
+#include "Planner.h"
+
+////////////////////////////////////////////////////
+//
+// Nonholonomic steering for car-like robots. States are VecN<3> = (x, y, theta).
+//
+// Curves are computed in closed form (Dubins: forward only, Reeds-Shepp:
+// forward and reverse). Computing them for every nearest-neighbour query
+// is too slow, so the metric reads distances from a precomputed,
+// memory-bounded SteeringTable and the exact curve is only evaluated for
+// the edges the planner actually inserts (steering and collision checks).
+//
+////////////////////////////////////////////////////
+
+typedef VecN<3> Pose;
+
+// A curve made of up to five arcs/lines; lengths are in units of the turning radius,
+// negative lengths are driven in reverse
+struct CurvePath {
+    enum Segment { LEFT, STRAIGHT, RIGHT, NONE };
+
+    Segment types[5];
+    float lengths[5];
+
+    CurvePath();
+    CurvePath(Segment a, Segment b, Segment c, float t, float u, float v);
+    CurvePath(Segment a, Segment b, Segment c, Segment d, float t, float u, float v, float w);
+    CurvePath(Segment a, Segment b, Segment c, Segment d, Segment e, float t, float u, float v, float w, float z);
+
+    // total length, in units of the turning radius
+    float length() const;
+    bool valid() const { return types[0] != NONE; }
+};
+
+struct DubinsCurve {
+    static CurvePath shortest(const Pose& from, const Pose& to, float turningRadius);
+};
+
+// All five word families, CSC, CCC, CCCC, CCSC and CCSCC, with their time-flip, reflection
+// and backwards variants (as in OMPL), so the result is the optimal Reeds-Shepp path
+struct ReedsSheppCurve {
+    static CurvePath shortest(const Pose& from, const Pose& to, float turningRadius);
+};
+
+// state reached after driving `distance` (world units) along path from `from`
+Pose interpolateCurve(const Pose& from, const CurvePath& path, float turningRadius, float distance);
+
+float wrapAngle(float angle);
+
+
+// Curve lengths sampled on a regular (dx, dy, dtheta) grid expressed in the start pose frame.
+// The grid resolution is chosen to fit in maxBytes; poses outside the covered range fall back
+// to the exact curve.
+class SteeringTable {
+public:
+    typedef CurvePath (*Shortest)(const Pose&, const Pose&, float);
+
+    SteeringTable(Shortest shortest, float turningRadius, float range, size_t maxBytes);
+
+    float distance(const Pose& from, const Pose& to) const;
+    float exactDistance(const Pose& from, const Pose& to) const;
+
+    float getTurningRadius() const { return turningRadius; }
+    size_t sizeInBytes() const { return cells.size() * sizeof(float); }
+
+private:
+    float cell(int ix, int iy, int it) const {
+        return cells[(static_cast<size_t>(it) * n + iy) * n + ix];
+    }
+
+    Shortest shortest;
+    float turningRadius;
+    float range;
+    int n;             // samples per x/y axis
+    int nTheta;        // samples over the heading
+    float spacing;
+    float thetaSpacing;
+    std::vector<float> cells;
+};
+
+
+// Metric policy for Planner<...>: table lookups for distances, exact curves for steering.
+// The table is shared by every planner of the process and built once, on first use; it is
+// never replaced, so planners may hold on to it.
+template <class Curve>
+struct CurveMetric {
+    typedef Pose State;
+
+    // sets the parameters of the table; only before the first planner uses it, false afterwards
+    static bool configure(float turningRadius, float tableRange, size_t tableBytes = 1 << 20) {
+        std::lock_guard<std::mutex> lock(settings().lock);
+        if (settings().built) {
+            std::cerr << "CurveMetric::configure: the steering table is already in use\n";
+            return false;
+        }
+        settings().turningRadius = turningRadius;
+        settings().tableRange = tableRange;
+        settings().tableBytes = tableBytes;
+        return true;
+    }
+
+    static const SteeringTable& table() {
+        // C++11 guarantees the initialization runs exactly once, even with concurrent callers
+        static const SteeringTable instance = buildTable();
+        return instance;
+    }
+
+    static float turningRadius() { return table().getTurningRadius(); }
+
+    static float distance(const State& p1, const State& p2) {
+        return table().distance(p1, p2);
+    }
+
+    static float distance2(const State& p1, const State& p2) {
+        float d = distance(p1, p2);
+        return d * d;
+    }
+
+    // drives the exact curve from `from` towards `towards` for at most stepSize
+    static State steer(const State& from, const State& towards, float stepSize) {
+        CurvePath path = Curve::shortest(from, towards, turningRadius());
+        if (!path.valid() || path.length() * turningRadius() <= stepSize) return towards;
+        return interpolateCurve(from, path, turningRadius(), stepSize);
+    }
+
+    static size_t nearest(const float* const coords[3], size_t count, const State& point) {
+        size_t best = 0;
+        float bestDist = std::numeric_limits<float>::max();
+        for (size_t i = 0; i < count; ++i) {
+            float d = distance(Pose{coords[0][i], coords[1][i], coords[2][i]}, point);
+            if (d < bestDist) {
+                bestDist = d;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+private:
+    struct Settings {
+        std::mutex lock;
+        bool built = false;
+        float turningRadius = 20.0f;
+        float tableRange = 160.0f;
+        size_t tableBytes = 1 << 20;
+    };
+
+    static Settings& settings() {
+        static Settings instance;
+        return instance;
+    }
+
+    static SteeringTable buildTable() {
+        std::lock_guard<std::mutex> lock(settings().lock);
+        settings().built = true;
+        return SteeringTable(&Curve::shortest, settings().turningRadius, settings().tableRange, settings().tableBytes);
+    }
+};
+
+// Paths are reported with the exact curve length and drawn along the curve, one point every
+// two world units
+template <class Curve>
+struct EdgeShape<CurveMetric<Curve> > {
+    static float length(const Pose& from, const Pose& to) {
+        const float rho = CurveMetric<Curve>::turningRadius();
+        return Curve::shortest(from, to, rho).length() * rho;
+    }
+
+    static void trace(const Pose& from, const Pose& to, std::vector<Pose>& points) {
+        const float rho = CurveMetric<Curve>::turningRadius();
+        CurvePath path = Curve::shortest(from, to, rho);
+        const float length = path.length() * rho;
+        const int steps = std::max(1, static_cast<int>(std::ceil(length / 2.0f)));
+        for (int i = 1; i < steps; ++i) {
+            points.push_back(interpolateCurve(from, path, rho, length * i / steps));
+        }
+        points.push_back(to);
+    }
+};
+
+typedef CurveMetric<DubinsCurve> DubinsMetric;
+typedef CurveMetric<ReedsSheppCurve> ReedsSheppMetric;
+
+
+// Collision policy: the exact curve of an edge is sampled every `resolution` world units and
+// each piece is tested as a segment against the obstacles, inflated once by the footprint.
+// The robot turns along the curve, so a rectangle footprint is replaced by the disc around it,
+// which covers every heading.
+template <class Curve>
+class CurveCollision {
+public:
+    explicit CurveCollision(const std::vector<sf::RectangleShape>& obstacles,
+                            const std::vector<sf::ConvexShape>& shapes = std::vector<sf::ConvexShape>(),
+                            const Footprint& footprint = Footprint::point(), float resolution = 2.0f)
+        : obstacles(obstacles, shapes, anyHeading(footprint)), resolution(resolution) {}
+
+    bool edgeFree(const Pose& p1, const Pose& p2) const {
+        const float rho = CurveMetric<Curve>::turningRadius();
+        CurvePath path = Curve::shortest(p1, p2, rho);
+        if (!path.valid()) return false;
+
+        const float length = path.length() * rho;
+        const int steps = std::max(1, static_cast<int>(std::ceil(length / resolution)));
+        Vec2 previous{p1[0], p1[1]};
+        for (int i = 1; i <= steps; ++i) {
+            Pose s = interpolateCurve(p1, path, rho, length * i / steps);
+            Vec2 current{s[0], s[1]};
+            if (!obstacles.edgeFree(previous, current)) return false;
+            previous = current;
+        }
+        return true;
+    }
+
+    void edgeFreeBatch(const std::vector<Pose>& from, const std::vector<Pose>& to, std::vector<char>& isFree) const {
+        isFree.resize(from.size());
+        for (size_t i = 0; i < from.size(); ++i) {
+            isFree[i] = edgeFree(from[i], to[i]);
+        }
+    }
+
+private:
+    static Footprint anyHeading(const Footprint& footprint) {
+        if (footprint.isPoint() || footprint.radius > 0.0f) return footprint;
+        return Footprint::disc(std::sqrt(footprint.halfWidth * footprint.halfWidth + footprint.halfHeight * footprint.halfHeight));
+    }
+
+    AABBCollision obstacles;
+    float resolution;
+};
+
+
+// Landing exactly on a goal pose by sampling is unlikely, so once a new node is within the
+// planner radius (table distance) the exact curve to the goal is collision checked instead
+template <class Extender>
+struct GoalConnectExtender : Extender {
+    template <class P>
+    bool reached(const P& planner, const typename P::NodeType* node) const {
+        return P::MetricType::distance(node->position, planner.getGoal()) < planner.getRadius() &&
+               planner.collision().edgeFree(node->position, planner.getGoal());
+    }
+};
+
+template <class Curve>
+using CurveRRT = Planner<UniformSampler, LinearIndex<CurveMetric<Curve> >, CurveCollision<Curve>, CurveMetric<Curve>, GoalConnectExtender<StepExtender> >;
+
+template <class Curve>
+using CurveRRTStar = Planner<UniformSampler, LinearIndex<CurveMetric<Curve> >, CurveCollision<Curve>, CurveMetric<Curve>, GoalConnectExtender<RewireExtender<LinearIndex<CurveMetric<Curve> > > > >;
+
+typedef CurveRRT<DubinsCurve> DubinsRRT;
+typedef CurveRRTStar<DubinsCurve> DubinsRRTStar;
+typedef CurveRRT<ReedsSheppCurve> ReedsSheppRRT;
+typedef CurveRRTStar<ReedsSheppCurve> ReedsSheppRRTStar;
@@ -0,0 +1,186 @@
+#include "TiledWorld.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cmath>
+#include <cerrno>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char MAGIC[4] = {'P', 'P', 'T', 'W'};
+
+int64_t tileKey(int col, int row) {
+    return (static_cast<int64_t>(row) << 32) | static_cast<uint32_t>(col);
+}
+
+} // namespace
+
+TiledWorld::TiledWorld(size_t cacheTiles)
+    : capacity(std::max<size_t>(cacheTiles, 1)), loads(0), lastPrefetch(-1) {
+    std::memset(&header, 0, sizeof(header));
+}
+
+std::string TiledWorld::tilePath(int col, int row) const {
+    std::ostringstream path;
+    path << directory << "/tile_" << col << "_" << row << ".bin";
+    return path.str();
+}
+
+int TiledWorld::colOf(float x) const {
+    int col = static_cast<int>(std::floor((x - header.worldMinX) / header.tileSize));
+    return std::min(std::max(col, 0), static_cast<int>(header.cols) - 1);
+}
+
+int TiledWorld::rowOf(float y) const {
+    int row = static_cast<int>(std::floor((y - header.worldMinY) / header.tileSize));
+    return std::min(std::max(row, 0), static_cast<int>(header.rows) - 1);
+}
+
+bool TiledWorld::build(const std::string& directory, const ObstacleRect* rects, size_t count,
+                       float worldMinX, float worldMinY, float worldMaxX, float worldMaxY, float tileSize) {
+    // an existing directory is reused, its tiles are overwritten below
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << "TiledWorld: cannot create " << directory << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    TiledWorldHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = VERSION;
+    h.worldMinX = worldMinX;
+    h.worldMinY = worldMinY;
+    h.worldMaxX = worldMaxX;
+    h.worldMaxY = worldMaxY;
+    h.tileSize = tileSize;
+    h.cols = static_cast<uint32_t>(std::ceil((worldMaxX - worldMinX) / tileSize));
+    h.rows = static_cast<uint32_t>(std::ceil((worldMaxY - worldMinY) / tileSize));
+
+    std::ofstream out((directory + "/world.bin").c_str(), std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "TiledWorld: cannot write " << directory << "/world.bin\n";
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.close();
+
+    // bucket every obstacle into each tile it overlaps
+    TiledWorld layout;
+    layout.header = h;
+    std::vector<std::vector<ObstacleRect> > buckets(static_cast<size_t>(h.cols) * h.rows);
+    for (size_t i = 0; i < count; ++i) {
+        int c0 = layout.colOf(rects[i].minX), c1 = layout.colOf(rects[i].maxX);
+        int r0 = layout.rowOf(rects[i].minY), r1 = layout.rowOf(rects[i].maxY);
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                buckets[static_cast<size_t>(r) * h.cols + c].push_back(rects[i]);
+            }
+        }
+    }
+
+    layout.directory = directory;
+    const std::vector<ScenarioQuery> noQueries;
+    for (uint32_t r = 0; r < h.rows; ++r) {
+        for (uint32_t c = 0; c < h.cols; ++c) {
+            std::vector<ObstacleRect>& bucket = buckets[static_cast<size_t>(r) * h.cols + c];
+            if (bucket.empty()) continue;
+
+            float minX = worldMinX + c * tileSize, minY = worldMinY + r * tileSize;
+            if (!Scenario::save(layout.tilePath(c, r), minX, minY, minX + tileSize, minY + tileSize, bucket, noQueries)) {
+                return false;
+            }
+            std::vector<ObstacleRect>().swap(bucket);
+        }
+    }
+    return true;
+}
+
+bool TiledWorld::open(const std::string& dir) {
+    std::lock_guard<std::mutex> lock(cacheLock);
+    order.clear();
+    tiles.clear();
+    lastPrefetch = -1;
+    directory = dir;
+
+    std::ifstream in((dir + "/world.bin").c_str(), std::ios::binary);
+    if (!in || !in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        std::cerr << "TiledWorld: cannot read " << dir << "/world.bin\n";
+        return false;
+    }
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.cols == 0 || header.rows == 0 || !(header.tileSize > 0)) {
+        std::cerr << "TiledWorld: " << dir << "/world.bin is not a version " << VERSION << " tiled world\n";
+        return false;
+    }
+    return true;
+}
+
+TiledWorld::Tile& TiledWorld::tileAt(int col, int row) {
+    const int64_t key = tileKey(col, row);
+
+    auto found = tiles.find(key);
+    if (found != tiles.end()) {
+        order.splice(order.begin(), order, found->second.position);
+        return *found->second.tile;
+    }
+
+    // miss: map the tile file (missing file = empty tile), evicting the least recently used
+    std::unique_ptr<Tile> tile(new Tile());
+    const std::string path = tilePath(col, row);
+    if (access(path.c_str(), R_OK) == 0) {
+        tile->scenario.load(path);
+    }
+    ++loads;
+
+    while (tiles.size() >= capacity) {
+        tiles.erase(order.back());
+        order.pop_back();
+    }
+
+    order.push_front(key);
+    Entry& entry = tiles[key];
+    entry.position = order.begin();
+    entry.tile = std::move(tile);
+    return *entry.tile;
+}
+
+bool TiledWorld::edgeFree(const Vec2& p1, const Vec2& p2) {
+    std::lock_guard<std::mutex> lock(cacheLock);
+    const float minX = std::min(p1[0], p2[0]), maxX = std::max(p1[0], p2[0]);
+    const float minY = std::min(p1[1], p2[1]), maxY = std::max(p1[1], p2[1]);
+
+    for (int r = rowOf(minY); r <= rowOf(maxY); ++r) {
+        for (int c = colOf(minX); c <= colOf(maxX); ++c) {
+            Tile& tile = tileAt(c, r);
+            if (!tile.scenario.isLoaded()) continue;
+
+            if (!tile.index) {
+                tile.index.reset(new ObstacleIndex(tile.scenario.obstacles(), tile.scenario.obstacleCount()));
+            }
+            if (!tile.index->boxFree(minX, minY, maxX, maxY)) return false;
+        }
+    }
+    return true;
+}
+
+void TiledWorld::prefetchAround(const Vec2& point) {
+    if (capacity < PREFETCH_MIN_TILES) return;
+    std::lock_guard<std::mutex> lock(cacheLock);
+    const int col = colOf(point[0]), row = rowOf(point[1]);
+    const int64_t key = tileKey(col, row);
+    if (key == lastPrefetch) return;
+    lastPrefetch = key;
+
+    for (int r = std::max(row - 1, 0); r <= std::min(row + 1, static_cast<int>(header.rows) - 1); ++r) {
+        for (int c = std::max(col - 1, 0); c <= std::min(col + 1, static_cast<int>(header.cols) - 1); ++c) {
+            if (r == row && c == col) continue;
+            tileAt(c, r).scenario.prefetch();
+        }
+    }
+    // keep the tile under the tree as the most recently used one
+    tileAt(col, row);
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <unordered_map>
+#include "Planner.h"
+#include "Scenario.h"
+
+////////////////////////////////////////////////////
+//
+// Worlds too large to keep in memory, split into square tiles.
+//
+// On disk a tiled world is a directory holding
+//   world.bin                 TiledWorldHeader (bounds, tile size, grid)
+//   tile_<col>_<row>.bin      one scenario file per non-empty tile with every
+//                             obstacle overlapping it
+//
+// Tiles are mapped on demand as edge checks touch them and kept in an LRU
+// cache of fixed capacity; evicted tiles are unmapped. When the tree grows
+// into a new tile its eight neighbours are prefetched, which only maps them
+// and lets the kernel read them in the background. The cache is guarded by
+// a mutex, so one world may serve planners on several threads.
+//
+////////////////////////////////////////////////////
+
+struct TiledWorldHeader {
+    char magic[4];              // "PPTW"
+    uint32_t version;
+    float worldMinX, worldMinY;
+    float worldMaxX, worldMaxY;
+    float tileSize;
+    uint32_t cols, rows;
+    uint8_t reserved[12];
+};
+
+static_assert(sizeof(TiledWorldHeader) == 48, "TiledWorldHeader is part of the file format");
+
+class TiledWorld {
+public:
+    static const uint32_t VERSION = 1;
+
+    // below this many cached tiles the prefetched neighbours would evict the tiles in use
+    static const size_t PREFETCH_MIN_TILES = 16;
+
+    // prefetching is off when cacheTiles < PREFETCH_MIN_TILES
+    explicit TiledWorld(size_t cacheTiles = 64);
+
+    TiledWorld(const TiledWorld&) = delete;
+    TiledWorld& operator=(const TiledWorld&) = delete;
+
+    // splits the obstacles into tiles under directory (created if missing)
+    static bool build(const std::string& directory, const ObstacleRect* rects, size_t count,
+                      float worldMinX, float worldMinY, float worldMaxX, float worldMaxY, float tileSize);
+
+    // reads world.bin; on failure prints the reason to std::cerr and returns false
+    bool open(const std::string& directory);
+
+    // same bounding box test as AABBCollision, over every tile the edge touches
+    bool edgeFree(const Vec2& p1, const Vec2& p2);
+
+    // maps the neighbours of the tile under point, once per tile change
+    void prefetchAround(const Vec2& point);
+
+    Vec2 getLower() const { return Vec2{header.worldMinX, header.worldMinY}; }
+    Vec2 getUpper() const { return Vec2{header.worldMaxX, header.worldMaxY}; }
+
+    size_t residentTiles() const {
+        std::lock_guard<std::mutex> lock(cacheLock);
+        return tiles.size();
+    }
+
+    size_t tileLoads() const {
+        std::lock_guard<std::mutex> lock(cacheLock);
+        return loads;
+    }
+
+private:
+    struct Tile {
+        Scenario scenario;                      // unmapped when the tile file does not exist
+        std::unique_ptr<ObstacleIndex> index;   // built on first use, not on prefetch
+    };
+
+    struct Entry {
+        std::list<int64_t>::iterator position;
+        std::unique_ptr<Tile> tile;
+    };
+
+    // cacheLock must be held
+    Tile& tileAt(int col, int row);
+    std::string tilePath(int col, int row) const;
+    int colOf(float x) const;
+    int rowOf(float y) const;
+
+    std::string directory;
+    TiledWorldHeader header;
+    size_t capacity;
+    size_t loads;
+    int64_t lastPrefetch;
+
+    mutable std::mutex cacheLock;               // guards loads, lastPrefetch, order and tiles
+    std::list<int64_t> order;                   // most recently used first
+    std::unordered_map<int64_t, Entry> tiles;
+};
+
+
+// Collision policy over a TiledWorld; copies share the same world and cache, which the world
+// locks, so planners on several threads may use them. Each free edge prefetches the tiles
+// around its end point, which is where the tree grows.
+class TiledCollision {
+public:
+    explicit TiledCollision(TiledWorld& world) : world(&world) {}
+
+    bool edgeFree(const Vec2& p1, const Vec2& p2) const {
+        if (!world->edgeFree(p1, p2)) return false;
+        world->prefetchAround(p2);
+        return true;
+    }
+
+    void edgeFreeBatch(const std::vector<Vec2>& from, const std::vector<Vec2>& to, std::vector<char>& isFree) const {
+        isFree.resize(from.size());
+        for (size_t i = 0; i < from.size(); ++i) {
+            isFree[i] = edgeFree(from[i], to[i]);
+        }
+    }
+
+private:
+    TiledWorld* world;
+};
+
+typedef Planner<UniformSampler, LinearIndex<EuclideanMetric<2> >, TiledCollision, EuclideanMetric<2>, StepExtender> TiledRRT;
+typedef Planner<UniformSampler, LinearIndex<EuclideanMetric<2> >, TiledCollision, EuclideanMetric<2>, RewireExtender<LinearIndex<EuclideanMetric<2> > > > TiledRRTStar;
@@ -0,0 +1,238 @@
+#include "TreeSnapshot.h"
+
+#include <iostream>
+#include <iterator>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+const char MAGIC[4] = {'P', 'P', 'T', 'R'};
+const size_t HEADER_BYTES = 32;
+const size_t CHUNK_HEADER_BYTES = 12;
+
+void putU32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+uint32_t getU32(const uint8_t* data) {
+    return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 |
+           static_cast<uint32_t>(data[2]) << 16 | static_cast<uint32_t>(data[3]) << 24;
+}
+
+void putVarint(std::string& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void putSigned(std::string& out, int32_t value) {
+    putVarint(out, (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+}
+
+// false when the varint runs past end
+bool getVarint(const uint8_t*& data, const uint8_t* end, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35 && data < end; shift += 7) {
+        const uint8_t byte = *data++;
+        value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+bool getSigned(const uint8_t*& data, const uint8_t* end, int32_t& value) {
+    uint32_t raw;
+    if (!getVarint(data, end, raw)) return false;
+    value = static_cast<int32_t>(raw >> 1) ^ -static_cast<int32_t>(raw & 1);
+    return true;
+}
+
+} // namespace
+
+TreeRecorder::TreeRecorder()
+    : dimension(0), quantum(1.0f), chunkCount(0), recorded(0), lastIteration(0), written(0) {}
+
+TreeRecorder::~TreeRecorder() {
+    close();
+}
+
+bool TreeRecorder::open(const std::string& path, int dimension, float quantum) {
+    close();
+    if (dimension < 1 || dimension > MAX_DIMENSION || !(quantum > 0.0f)) {
+        std::cerr << "TreeRecorder: unsupported dimension or quantum\n";
+        return false;
+    }
+
+    out.open(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "TreeRecorder: cannot write " << path << "\n";
+        return false;
+    }
+    this->dimension = dimension;
+    this->quantum = quantum;
+    chunk.clear();
+    chunkCount = 0;
+    recorded = 0;
+    lastIteration = 0;
+    costs.clear();
+
+    uint32_t quantumBits;
+    std::memcpy(&quantumBits, &quantum, sizeof(quantumBits));
+    std::string header(MAGIC, sizeof(MAGIC));
+    putU32(header, VERSION);
+    putU32(header, static_cast<uint32_t>(dimension));
+    putU32(header, quantumBits);
+    header.resize(HEADER_BYTES, '\0');
+    out.write(header.data(), header.size());
+    written = header.size();
+    return true;
+}
+
+void TreeRecorder::close() {
+    if (!out.is_open()) return;
+    flush();
+    out.close();
+}
+
+void TreeRecorder::addNode(const float* position, const float* parentPosition, uint32_t parent, float cost, int iteration) {
+    if (!out.is_open()) return;
+
+    const uint32_t index = static_cast<uint32_t>(costs.size());
+    putVarint(chunk, static_cast<uint32_t>(std::max(iteration - lastIteration, 0)));
+    putVarint(chunk, index - parent);
+    for (int d = 0; d < dimension; ++d) {
+        putSigned(chunk, quantize(position[d]) - quantize(parentPosition[d]));
+    }
+    const int32_t quantizedCost = quantize(cost);
+    putSigned(chunk, quantizedCost - (parent == index ? 0 : costs[parent]));
+
+    costs.push_back(quantizedCost);
+    lastIteration = iteration;
+    ++chunkCount;
+    if (chunk.size() >= CHUNK_BYTES) flush();
+}
+
+void TreeRecorder::addPath(const std::vector<float>& flat) {
+    if (!out.is_open() || dimension == 0) return;
+    flush();
+
+    std::string payload;
+    std::vector<int32_t> previous(dimension, 0);
+    for (size_t i = 0; i < flat.size(); ++i) {
+        const int d = static_cast<int>(i % dimension);
+        const int32_t q = quantize(flat[i]);
+        putSigned(payload, q - previous[d]);
+        previous[d] = q;
+    }
+
+    std::string header;
+    putU32(header, PATH);
+    putU32(header, static_cast<uint32_t>(flat.size() / dimension));
+    putU32(header, static_cast<uint32_t>(payload.size()));
+    out.write(header.data(), header.size());
+    out.write(payload.data(), payload.size());
+    written += header.size() + payload.size();
+}
+
+void TreeRecorder::flush() {
+    if (chunkCount == 0) return;
+
+    std::string header;
+    putU32(header, NODES);
+    putU32(header, chunkCount);
+    putU32(header, static_cast<uint32_t>(chunk.size()));
+    out.write(header.data(), header.size());
+    out.write(chunk.data(), chunk.size());
+    out.flush();
+    written += header.size() + chunk.size();
+
+    chunk.clear();
+    chunkCount = 0;
+}
+
+
+bool TreeSnapshot::load(const std::string& path) {
+    *this = TreeSnapshot();
+
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in) {
+        std::cerr << "TreeSnapshot: cannot open " << path << "\n";
+        return false;
+    }
+    const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    if (bytes.size() < HEADER_BYTES || std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) != 0 ||
+        getU32(&bytes[4]) != TreeRecorder::VERSION) {
+        std::cerr << "TreeSnapshot: " << path << " is not a version " << TreeRecorder::VERSION << " tree snapshot\n";
+        return false;
+    }
+    const uint32_t quantumBits = getU32(&bytes[12]);
+    std::memcpy(&quantum, &quantumBits, sizeof(quantum));
+    dimension = static_cast<int>(getU32(&bytes[8]));
+    if (dimension < 1 || dimension > MAX_DIMENSION || !(quantum > 0.0f)) {
+        std::cerr << "TreeSnapshot: " << path << " has a bad header\n";
+        return false;
+    }
+
+    // a trailing chunk that does not fit is what a crash leaves behind; everything before it is kept
+    const uint8_t* data = bytes.data() + HEADER_BYTES;
+    const uint8_t* end = bytes.data() + bytes.size();
+    while (static_cast<size_t>(end - data) >= CHUNK_HEADER_BYTES) {
+        const uint32_t type = getU32(data), count = getU32(data + 4), size = getU32(data + 8);
+        data += CHUNK_HEADER_BYTES;
+        if (size > static_cast<size_t>(end - data)) break;
+
+        const bool decoded = type == TreeRecorder::NODES ? decodeNodes(data, data + size, count)
+                           : type == TreeRecorder::PATH ? decodePath(data, data + size, count)
+                           : true;    // unknown chunks are skipped
+        if (!decoded) {
+            std::cerr << "TreeSnapshot: " << path << " has a corrupt chunk\n";
+            return false;
+        }
+        data += size;
+    }
+    return true;
+}
+
+bool TreeSnapshot::decodeNodes(const uint8_t* data, const uint8_t* end, uint32_t count) {
+    for (uint32_t n = 0; n < count; ++n) {
+        const uint32_t index = static_cast<uint32_t>(parents.size());
+        uint32_t iterationDelta, parentDelta;
+        if (!getVarint(data, end, iterationDelta) || !getVarint(data, end, parentDelta) || parentDelta > index) return false;
+        const uint32_t parent = index - parentDelta;
+
+        for (int d = 0; d < dimension; ++d) {
+            int32_t delta;
+            if (!getSigned(data, end, delta)) return false;
+            const int32_t q = (parent == index ? 0 : quantized[parent * dimension + d]) + delta;
+            quantized.push_back(q);
+            positions.push_back(q * quantum);
+        }
+        int32_t costDelta;
+        if (!getSigned(data, end, costDelta)) return false;
+        const int32_t q = (parent == index ? 0 : quantizedCosts[parent]) + costDelta;
+        quantizedCosts.push_back(q);
+        costs.push_back(q * quantum);
+
+        parents.push_back(parent == index ? -1 : static_cast<int32_t>(parent));
+        iterations.push_back((iterations.empty() ? 0 : iterations.back()) + static_cast<int>(iterationDelta));
+    }
+    return data == end;
+}
+
+bool TreeSnapshot::decodePath(const uint8_t* data, const uint8_t* end, uint32_t count) {
+    std::vector<int32_t> previous(dimension, 0);
+    pathStates.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        for (int d = 0; d < dimension; ++d) {
+            int32_t delta;
+            if (!getSigned(data, end, delta)) return false;
+            previous[d] += delta;
+            pathStates.push_back(previous[d] * quantum);
+        }
+    }
+    return data == end;
+}
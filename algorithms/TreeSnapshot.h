@@ -0,0 +1,140 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <cmath>
+#include "VecN.h"
+
+////////////////////////////////////////////////////
+//
+// Tree snapshot stream, little-endian, version 1:
+//
+//   header            "PPTR", uint32 version, uint32 dimension, float quantum, 16 reserved bytes
+//   chunks until the end of the file, each
+//     uint32 type, uint32 count, uint32 bytes, payload[bytes]
+//
+// NODES chunk, one record per node in insertion order, all varints (signed ones zigzag):
+//   iteration - iteration of the previous node
+//   index - parent index (0 for the root)
+//   position - parent position, per component, in quanta (signed)
+//   cost - parent cost, in quanta (signed)
+// PATH chunk: count states, each the quantized delta from the previous one (the first from 0).
+//
+// Children sit about one step from their parent, so a node takes 8-10 bytes instead
+// of the 20+ of the raw floats. The recorder buffers one chunk at a time and writes
+// it whole, so a file cut short by a crash still loads up to its last complete chunk.
+// Besides that buffer the recorder keeps the quantized cost of every recorded node
+// (4 bytes each, the parent deltas are taken against them), so its memory is O(nodes),
+// a small fraction of what the planner itself keeps per node.
+//
+////////////////////////////////////////////////////
+
+class TreeRecorder {
+public:
+    enum ChunkType { NODES = 1, PATH = 2 };
+
+    static const uint32_t VERSION = 1;
+
+    TreeRecorder();
+    ~TreeRecorder();
+    TreeRecorder(const TreeRecorder&) = delete;
+    TreeRecorder& operator=(const TreeRecorder&) = delete;
+
+    // starts a new file; positions and costs are rounded to multiples of quantum.
+    // On failure prints the reason to std::cerr and returns false
+    bool open(const std::string& path, int dimension, float quantum = 1.0f / 16.0f);
+
+    // writes the buffered nodes and closes the file
+    void close();
+
+    bool isOpen() const { return out.is_open(); }
+
+    // appends the nodes the planner inserted since the previous call; called once per
+    // iteration this costs a few bytes per new node. Nodes are identified by their
+    // insertion index, which is also their record number in the file.
+    template <class P>
+    void record(const P& planner, int iteration) {
+        const auto& nodes = planner.index().all();
+        for (; recorded < nodes.size(); ++recorded) {
+            const auto* node = nodes[recorded];
+            uint32_t parent = static_cast<uint32_t>(recorded);
+            float parentPosition[MAX_DIMENSION] = {};
+            if (node->parent) {
+                parent = node->parent->index;
+                for (int d = 0; d < dimension; ++d) parentPosition[d] = node->parent->position[d];
+            }
+
+            float position[MAX_DIMENSION];
+            for (int d = 0; d < dimension; ++d) position[d] = node->position[d];
+            addNode(position, parentPosition, parent, node->cost, recorded == 0 ? 0 : iteration);
+        }
+    }
+
+    // the final path, written as its own chunk
+    template <class State>
+    void recordPath(const std::vector<State>& path) {
+        std::vector<float> flat;
+        for (const State& s : path) {
+            for (int d = 0; d < dimension; ++d) flat.push_back(s[d]);
+        }
+        addPath(flat);
+    }
+
+    uint64_t bytesWritten() const { return written; }
+
+private:
+    static const size_t CHUNK_BYTES = 16 * 1024;
+
+    void addNode(const float* position, const float* parentPosition, uint32_t parent, float cost, int iteration);
+    void addPath(const std::vector<float>& flat);
+    void flush();
+    int32_t quantize(float value) const { return static_cast<int32_t>(std::lround(value / quantum)); }
+
+    std::ofstream out;
+    int dimension;
+    float quantum;
+
+    std::string chunk;          // payload of the NODES chunk being filled
+    uint32_t chunkCount;
+    size_t recorded;            // nodes of the planner's tree already written
+    int lastIteration;
+    std::vector<int32_t> costs; // quantized cost per recorded node, deltas are taken against these
+    uint64_t written;
+};
+
+
+// A snapshot file decoded in memory, for replay
+class TreeSnapshot {
+public:
+    TreeSnapshot() : dimension(0), quantum(0.0f) {}
+
+    // on failure prints the reason to std::cerr and returns false
+    bool load(const std::string& path);
+
+    int getDimension() const { return dimension; }
+    size_t size() const { return parents.size(); }
+
+    const float* position(size_t node) const { return &positions[node * dimension]; }
+    int32_t parent(size_t node) const { return parents[node]; }       // -1 for the root
+    float cost(size_t node) const { return costs[node]; }
+    int iteration(size_t node) const { return iterations[node]; }
+
+    // states of the final path, dimension floats each; empty when the run failed or was cut short
+    const std::vector<float>& path() const { return pathStates; }
+
+private:
+    bool decodeNodes(const uint8_t* data, const uint8_t* end, uint32_t count);
+    bool decodePath(const uint8_t* data, const uint8_t* end, uint32_t count);
+
+    int dimension;
+    float quantum;
+    std::vector<int32_t> quantized;     // per node and component, to undo the parent deltas
+    std::vector<float> positions;
+    std::vector<int32_t> parents;
+    std::vector<float> costs;
+    std::vector<int32_t> quantizedCosts;
+    std::vector<int> iterations;
+    std::vector<float> pathStates;
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <initializer_list>
+
+#if defined(__SSE2__) || defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VECN_SSE2 1
+#endif
+
+////////////////////////////////////////////////////
+//
+// Fixed-size configuration-space vector. The dimension is a template
+// parameter so every loop over the components is unrolled by the compiler.
+//
+////////////////////////////////////////////////////
+
+// largest supported dimension; code that handles states of a runtime dimension
+// (e.g. the tree snapshots) sizes its buffers with it
+const int MAX_DIMENSION = 16;
+
+template <int D>
+struct VecN {
+    static_assert(D >= 1 && D <= MAX_DIMENSION, "VecN dimension must be in [1, MAX_DIMENSION]");
+    static const int dimension = D;
+
+    float v[D];
+
+    VecN() {
+        for (int i = 0; i < D; ++i) v[i] = 0.0f;
+    }
+
+    VecN(std::initializer_list<float> values) {
+        int i = 0;
+        for (float value : values) {
+            if (i < D) v[i++] = value;
+        }
+        for (; i < D; ++i) v[i] = 0.0f;
+    }
+
+    float& operator[](int i) { return v[i]; }
+    float operator[](int i) const { return v[i]; }
+
+    VecN& operator+=(const VecN& o) { for (int i = 0; i < D; ++i) v[i] += o.v[i]; return *this; }
+    VecN& operator-=(const VecN& o) { for (int i = 0; i < D; ++i) v[i] -= o.v[i]; return *this; }
+    VecN& operator*=(float s) { for (int i = 0; i < D; ++i) v[i] *= s; return *this; }
+    VecN& operator/=(float s) { for (int i = 0; i < D; ++i) v[i] /= s; return *this; }
+};
+
+template <int D> inline VecN<D> operator+(VecN<D> a, const VecN<D>& b) { return a += b; }
+template <int D> inline VecN<D> operator-(VecN<D> a, const VecN<D>& b) { return a -= b; }
+template <int D> inline VecN<D> operator*(VecN<D> a, float s) { return a *= s; }
+template <int D> inline VecN<D> operator*(float s, VecN<D> a) { return a *= s; }
+template <int D> inline VecN<D> operator/(VecN<D> a, float s) { return a /= s; }
+
+template <int D>
+inline bool operator==(const VecN<D>& a, const VecN<D>& b) {
+    for (int i = 0; i < D; ++i) {
+        if (a.v[i] != b.v[i]) return false;
+    }
+    return true;
+}
+
+template <int D>
+inline bool operator!=(const VecN<D>& a, const VecN<D>& b) { return !(a == b); }
+
+template <int D>
+inline float squaredNorm(const VecN<D>& a) {
+    float sum = 0.0f;
+    for (int i = 0; i < D; ++i) sum += a.v[i] * a.v[i];
+    return sum;
+}
+
+template <int D>
+inline float squaredDistance(const VecN<D>& a, const VecN<D>& b) {
+    float sum = 0.0f;
+    for (int i = 0; i < D; ++i) {
+        float d = a.v[i] - b.v[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+
+////////////////////////////////////////////////////
+//
+// SIMD kernel for nearest-neighbour scans over structure-of-arrays storage:
+// coords[d][n] is component d of point n. Four points are compared per
+// step; returns the index of the closest point and writes its squared
+// distance to bestDist.
+//
+////////////////////////////////////////////////////
+template <int D>
+inline size_t nearestSquared(const float* const coords[D], size_t count, const VecN<D>& query, float& bestDist) {
+    size_t best = 0;
+    bestDist = std::numeric_limits<float>::max();
+    size_t i = 0;
+
+#ifdef VECN_SSE2
+    if (count >= 4) {
+        __m128 bestV = _mm_set1_ps(std::numeric_limits<float>::max());
+        __m128i bestI = _mm_setzero_si128();
+        __m128i idx = _mm_set_epi32(3, 2, 1, 0);
+        const __m128i four = _mm_set1_epi32(4);
+
+        for (; i + 4 <= count; i += 4) {
+            __m128 acc = _mm_setzero_ps();
+            for (int d = 0; d < D; ++d) {
+                __m128 diff = _mm_sub_ps(_mm_loadu_ps(coords[d] + i), _mm_set1_ps(query.v[d]));
+                acc = _mm_add_ps(acc, _mm_mul_ps(diff, diff));
+            }
+            __m128 closer = _mm_cmplt_ps(acc, bestV);
+            bestV = _mm_min_ps(acc, bestV);
+            bestI = _mm_or_si128(_mm_and_si128(_mm_castps_si128(closer), idx),
+                                 _mm_andnot_si128(_mm_castps_si128(closer), bestI));
+            idx = _mm_add_epi32(idx, four);
+        }
+
+        float lanes[4];
+        int lanesI[4];
+        _mm_storeu_ps(lanes, bestV);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanesI), bestI);
+        for (int l = 0; l < 4; ++l) {
+            if (lanes[l] < bestDist || (lanes[l] == bestDist && static_cast<size_t>(lanesI[l]) < best)) {
+                bestDist = lanes[l];
+                best = static_cast<size_t>(lanesI[l]);
+            }
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        float sum = 0.0f;
+        for (int d = 0; d < D; ++d) {
+            float diff = coords[d][i] - query.v[d];
+            sum += diff * diff;
+        }
+        if (sum < bestDist) {
+            bestDist = sum;
+            best = i;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,335 @@
+#include "VisibilityGraph.h"
+
+#include <iostream>
+#include <cmath>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <queue>
+#include <limits>
+#include <algorithm>
+
+namespace {
+
+// graphs kept by forObstacles
+const size_t GRAPH_CACHE_SIZE = 8;
+
+// Monotone stand-in for the angle of (dx, dy), in [0, 4) starting at +x; cheaper than atan2
+double pseudoAngle(double dx, double dy) {
+    if (dy >= 0.0) return dx >= 0.0 ? dy / (dx + dy) : 1.0 - dx / (dy - dx);
+    return dx < 0.0 ? 2.0 + dy / (dx + dy) : 3.0 + dx / (dx - dy);
+}
+
+// A corner to test or an obstacle entering or leaving the sweep ray, at a pseudo-angle around
+// the corner being swept. At the same angle obstacles enter before the corners are tested and
+// leave after. An obstacle whose span ends exactly on a ray lies on one side of it and cannot
+// block it, so rounding in the angles only matters for spans that straddle a ray by far more.
+struct SweepEvent {
+    enum Type { ENTER, CORNER, LEAVE };
+
+    double angle;
+    float dist2;        // corners only
+    uint32_t item;      // type in the top two bits, corner or obstacle below
+
+    static SweepEvent make(double angle, Type type, int id, float dist2 = 0.0f) {
+        const SweepEvent event = {angle, dist2, static_cast<uint32_t>(type) << 30 | static_cast<uint32_t>(id)};
+        return event;
+    }
+    Type type() const { return static_cast<Type>(item >> 30); }
+    int id() const { return static_cast<int>(item & 0x3fffffff); }
+
+    bool operator<(const SweepEvent& other) const {
+        if (angle != other.angle) return angle < other.angle;
+        if (type() != other.type()) return type() < other.type();
+        return dist2 < other.dist2;
+    }
+};
+
+bool sameRay(float ax, float ay, float bx, float by) {
+    const float cross = ax * by - ay * bx;
+    const float dot = ax * bx + ay * by;
+    return dot > 0.0f && std::fabs(cross) <= 1e-6f * std::sqrt((ax * ax + ay * ay) * (bx * bx + by * by));
+}
+
+// The directions from (x, y) into the obstacle span at most a half turn, since (x, y) is not
+// inside it: first is the pseudo-angle of the first corner met turning from +x towards +y,
+// last of the last one. Returns false when (x, y) is every corner (a degenerate obstacle).
+bool obstacleSpan(const ObstacleRect& r, float x, float y, double& first, double& last) {
+    const double cx[4] = {r.minX - x, r.maxX - x, r.minX - x, r.maxX - x};
+    const double cy[4] = {r.minY - y, r.minY - y, r.maxY - y, r.maxY - y};
+    int firstCorner = -1, lastCorner = -1;
+    for (int a = 0; a < 4; ++a) {
+        if (cx[a] == 0.0 && cy[a] == 0.0) continue;
+        bool isFirst = true, isLast = true;
+        for (int b = 0; b < 4; ++b) {
+            const double cross = cx[a] * cy[b] - cy[a] * cx[b];
+            if (cross < 0.0) isFirst = false;
+            if (cross > 0.0) isLast = false;
+        }
+        if (isFirst && firstCorner < 0) firstCorner = a;
+        if (isLast && lastCorner < 0) lastCorner = a;
+    }
+    if (firstCorner < 0 || lastCorner < 0) return false;
+    first = pseudoAngle(cx[firstCorner], cy[firstCorner]);
+    last = pseudoAngle(cx[lastCorner], cy[lastCorner]);
+    return true;
+}
+
+// tangentAt leaves a corner two opposite quadrants to look into; an obstacle lying entirely in
+// one of the other two cannot block any of its segments
+bool outsideTangentQuadrants(const ObstacleRect& r, float x, float y, float dirX, float dirY) {
+    if (dirX * dirY > 0.0f) return (r.minX > x && r.minY > y) || (r.maxX < x && r.maxY < y);
+    return (r.minX > x && r.maxY < y) || (r.maxX < x && r.minY > y);
+}
+
+float squaredDistanceTo(const ObstacleRect& r, float x, float y) {
+    const float dx = std::max(std::max(r.minX - x, x - r.maxX), 0.0f);
+    const float dy = std::max(std::max(r.minY - y, y - r.maxY), 0.0f);
+    return dx * dx + dy * dy;
+}
+
+bool sameObstacles(const std::vector<ObstacleRect>& a, const std::vector<ObstacleRect>& b) {
+    return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(ObstacleRect)) == 0);
+}
+
+} // namespace
+
+VisibilityGraph::VisibilityGraph(const std::vector<ObstacleRect>& obstacles)
+    : rects(obstacles), index(rects.data(), rects.size()) {
+    for (const ObstacleRect& r : rects) {
+        const Corner corners[4] = {
+            {r.minX, r.minY, -1.0f, -1.0f},
+            {r.maxX, r.minY, 1.0f, -1.0f},
+            {r.minX, r.maxY, -1.0f, 1.0f},
+            {r.maxX, r.maxY, 1.0f, 1.0f}
+        };
+        for (const Corner& corner : corners) {
+            // corners buried inside another obstacle can never be reached
+            if (!index.boxFree(corner.x, corner.y, corner.x, corner.y)) continue;
+            cornerInfo.push_back(corner);
+            points.push_back(Vec2{corner.x, corner.y});
+        }
+    }
+
+    // one rotational sweep per corner: the ray turns once around it, and only the obstacles it
+    // currently crosses, nearest first, are tested against each bitangent corner it passes
+    const int n = static_cast<int>(cornerInfo.size());
+    adjacency.resize(n);
+    std::vector<SweepEvent> events;
+    std::vector<float> reach(rects.size());
+    std::vector<std::pair<float, int> > active;    // kept sorted, nearest first
+    for (int i = 0; i < n; ++i) {
+        const Corner& from = cornerInfo[i];
+
+        events.clear();
+        active.clear();
+        for (size_t r = 0; r < rects.size(); ++r) {
+            double first, last;
+            if (outsideTangentQuadrants(rects[r], from.x, from.y, from.dirX, from.dirY)) continue;
+            if (!obstacleSpan(rects[r], from.x, from.y, first, last)) continue;
+            reach[r] = squaredDistanceTo(rects[r], from.x, from.y);
+            // the sweep starts at +x, a span across it is already under the ray
+            if (last < first) {
+                active.push_back(std::make_pair(reach[r], static_cast<int>(r)));
+            }
+            events.push_back(SweepEvent::make(first, SweepEvent::ENTER, static_cast<int>(r)));
+            events.push_back(SweepEvent::make(last, SweepEvent::LEAVE, static_cast<int>(r)));
+        }
+        for (int j = 0; j < n; ++j) {
+            const float dx = cornerInfo[j].x - from.x, dy = cornerInfo[j].y - from.y;
+            if (dx == 0.0f && dy == 0.0f) continue;
+            if (!tangentAt(from, dx, dy) || !tangentAt(cornerInfo[j], dx, dy)) continue;
+
+            events.push_back(SweepEvent::make(pseudoAngle(dx, dy), SweepEvent::CORNER, j, dx * dx + dy * dy));
+        }
+        std::sort(events.begin(), events.end());
+        std::sort(active.begin(), active.end());
+
+        // on a ray only the nearest corner is tested: the farther ones are either
+        // blocked too or reachable through it at the same length
+        int rayHead = -1;
+        for (const SweepEvent& event : events) {
+            const int id = event.id();
+            if (event.type() != SweepEvent::CORNER) {
+                const std::pair<float, int> item(reach[id], id);
+                auto at = std::lower_bound(active.begin(), active.end(), item);
+                if (event.type() == SweepEvent::ENTER) {
+                    active.insert(at, item);
+                } else if (at != active.end() && *at == item) {
+                    active.erase(at);
+                }
+                continue;
+            }
+
+            const Corner& to = cornerInfo[id];
+            if (rayHead >= 0 && sameRay(cornerInfo[rayHead].x - from.x, cornerInfo[rayHead].y - from.y, to.x - from.x, to.y - from.y)) {
+                continue;
+            }
+            rayHead = id;
+
+            // an obstacle that starts beyond the corner cannot block it (padded for rounding)
+            const float limit = event.dist2 * 1.0001f;
+            bool visible = true;
+            for (size_t k = 0; visible && k < active.size() && active[k].first <= limit; ++k) {
+                visible = !index.segmentCrosses(active[k].second, from.x, from.y, to.x, to.y);
+            }
+            if (visible) {
+                Edge edge = {id, std::sqrt(event.dist2)};
+                adjacency[i].push_back(edge);
+            }
+        }
+    }
+}
+
+bool VisibilityGraph::tangentAt(const Corner& corner, float dx, float dy) {
+    // the line through the corner must leave both rectangle edges meeting there on the same side
+    return corner.dirX * corner.dirY * dx * dy <= 0.0f;
+}
+
+std::shared_ptr<const VisibilityGraph> VisibilityGraph::forObstacles(const std::vector<ObstacleRect>& obstacles) {
+    typedef std::pair<std::vector<ObstacleRect>, std::shared_ptr<const VisibilityGraph> > CacheEntry;
+    static std::mutex cacheLock;
+    static std::list<CacheEntry> cache;    // most recently used first
+
+    {
+        std::lock_guard<std::mutex> lock(cacheLock);
+        for (auto it = cache.begin(); it != cache.end(); ++it) {
+            if (sameObstacles(it->first, obstacles)) {
+                cache.splice(cache.begin(), cache, it);
+                return cache.front().second;
+            }
+        }
+    }
+
+    // built outside the lock; two threads racing on a new set both build it, which is harmless
+    std::shared_ptr<const VisibilityGraph> graph = std::make_shared<VisibilityGraph>(obstacles);
+
+    std::lock_guard<std::mutex> lock(cacheLock);
+    cache.push_front(CacheEntry(obstacles, graph));
+    if (cache.size() > GRAPH_CACHE_SIZE) cache.pop_back();
+    return graph;
+}
+
+bool VisibilityGraph::shortestPath(const Vec2& start, const Vec2& goal, std::vector<Vec2>& path, float& cost, int* expanded) const {
+    path.clear();
+    cost = 0.0f;
+    if (expanded) *expanded = 0;
+
+    if (!index.boxFree(start[0], start[1], start[0], start[1]) || !index.boxFree(goal[0], goal[1], goal[0], goal[1])) {
+        return false;
+    }
+    if (index.segmentFree(start[0], start[1], goal[0], goal[1])) {
+        path.push_back(start);
+        path.push_back(goal);
+        cost = std::sqrt(squaredDistance(start, goal));
+        return true;
+    }
+
+    // the query points are linked to the cached graph, never added to it
+    const int n = static_cast<int>(points.size());
+    const int startId = n, goalId = n + 1;
+
+    std::vector<Edge> startEdges;
+    std::vector<float> toGoal(n, -1.0f);
+    for (int c = 0; c < n; ++c) {
+        const Corner& corner = cornerInfo[c];
+        if (tangentAt(corner, corner.x - start[0], corner.y - start[1]) &&
+            index.segmentFree(start[0], start[1], corner.x, corner.y)) {
+            Edge edge = {c, std::sqrt(squaredDistance(start, points[c]))};
+            startEdges.push_back(edge);
+        }
+        if (tangentAt(corner, goal[0] - corner.x, goal[1] - corner.y) &&
+            index.segmentFree(corner.x, corner.y, goal[0], goal[1])) {
+            toGoal[c] = std::sqrt(squaredDistance(points[c], goal));
+        }
+    }
+
+    // A* with the straight-line distance to the goal as heuristic
+    const float infinity = std::numeric_limits<float>::max();
+    std::vector<float> g(n + 2, infinity);
+    std::vector<int> parent(n + 2, -1);
+    std::vector<char> closed(n + 2, 0);
+    typedef std::pair<float, int> QueueItem;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > open;
+
+    auto heuristic = [&](int id) {
+        return id == goalId ? 0.0f : std::sqrt(squaredDistance(id == startId ? start : points[id], goal));
+    };
+    auto relax = [&](int from, int to, float length) {
+        const float candidate = g[from] + length;
+        if (candidate < g[to]) {
+            g[to] = candidate;
+            parent[to] = from;
+            open.push(QueueItem(candidate + heuristic(to), to));
+        }
+    };
+
+    g[startId] = 0.0f;
+    open.push(QueueItem(heuristic(startId), startId));
+    while (!open.empty()) {
+        const int current = open.top().second;
+        open.pop();
+        if (closed[current]) continue;
+        closed[current] = 1;
+        if (expanded) ++*expanded;
+
+        if (current == goalId) break;
+
+        if (current == startId) {
+            for (const Edge& edge : startEdges) relax(current, edge.to, edge.length);
+            continue;
+        }
+        for (const Edge& edge : adjacency[current]) relax(current, edge.to, edge.length);
+        if (toGoal[current] >= 0.0f) relax(current, goalId, toGoal[current]);
+    }
+
+    if (g[goalId] == infinity) return false;
+
+    for (int id = goalId; id != -1; id = parent[id]) {
+        path.push_back(id == goalId ? goal : id == startId ? start : points[id]);
+    }
+    std::reverse(path.begin(), path.end());
+    cost = g[goalId];
+    return true;
+}
+
+
+VisibilityPlanner::VisibilityPlanner(sf::Vector2f start, sf::Vector2f goal, const std::vector<sf::RectangleShape>& obstacles)
+    : start(toVec2(start)), goal(toVec2(goal)), graph(VisibilityGraph::forObstacles(toObstacleRects(obstacles))),
+      pathLength(0), color(sf::Color::Cyan) {}
+
+bool VisibilityPlanner::run() {
+    int expanded = 0;
+    if (!graph->shortestPath(start, goal, path, pathLength, &expanded)) {
+        std::cout << "final VisibilityGraph: no path\n";
+        return false;
+    }
+    std::cout << "final VisibilityGraph Expanded: " << expanded << "\n";
+    std::cout << "final VisibilityGraph Distance: " << pathLength << "\n";
+    return true;
+}
+
+void VisibilityPlanner::drawPath(sf::RenderWindow& window) const {
+    for (size_t i = 1; i < path.size(); ++i) {
+        sf::Vertex line[] = {
+            sf::Vertex(toVector2f(path[i - 1]), color),
+            sf::Vertex(toVector2f(path[i]), color)
+        };
+        window.draw(line, 2, sf::Lines);
+    }
+}
+
+void VisibilityPlanner::drawTree(sf::RenderWindow& window) const {
+    const std::vector<Vec2>& corners = graph->corners();
+    const std::vector<std::vector<VisibilityGraph::Edge> >& edges = graph->edges();
+    for (size_t i = 0; i < edges.size(); ++i) {
+        for (const VisibilityGraph::Edge& edge : edges[i]) {
+            if (static_cast<size_t>(edge.to) < i) continue;
+            sf::Vertex line[] = {
+                sf::Vertex(toVector2f(corners[i]), sf::Color(100,100,100,80)),
+                sf::Vertex(toVector2f(corners[edge.to]), sf::Color(100,100,100,80))
+            };
+            window.draw(line, 2, sf::Lines);
+        }
+    }
+}
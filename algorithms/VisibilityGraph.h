@@ -0,0 +1,87 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <memory>
+#include "Obstacles.h"
+
+////////////////////////////////////////////////////
+//
+// Exact shortest paths among axis-aligned rectangles.
+//
+// The shortest path only bends at obstacle corners, so the graph holds the
+// corners that are not buried inside another obstacle and the free segments
+// between them. Only bitangent segments are kept (the line grazes both
+// corners' rectangles without entering them); any other segment can always
+// be shortened. The edges come from a rotational sweep around each corner:
+// the bitangent corners and the angular spans of the obstacles are sorted by
+// angle, and while the ray turns an active set holds the obstacles it
+// crosses. The obstacles may overlap, so their order along the ray changes
+// as it turns; the set is kept ordered by each obstacle's fixed distance from
+// the corner instead, and a candidate is tested only against the active
+// obstacles nearer than itself, nearest first.
+// On a ray with several collinear corners just the nearest one is tested.
+//
+// The graph depends only on the obstacles, so it is built once per obstacle
+// set and shared (see forObstacles). Queries add the start and goal and run A*.
+//
+////////////////////////////////////////////////////
+class VisibilityGraph {
+public:
+    struct Edge {
+        int to;
+        float length;
+    };
+
+    VisibilityGraph(const std::vector<ObstacleRect>& obstacles);
+
+    VisibilityGraph(const VisibilityGraph&) = delete;
+    VisibilityGraph& operator=(const VisibilityGraph&) = delete;
+
+    // graph for this obstacle set, built on first use and kept in a small cache shared by all callers
+    static std::shared_ptr<const VisibilityGraph> forObstacles(const std::vector<ObstacleRect>& obstacles);
+
+    // A* from start to goal; false when either point is inside an obstacle or they are not connected
+    bool shortestPath(const Vec2& start, const Vec2& goal, std::vector<Vec2>& path, float& cost, int* expanded = nullptr) const;
+
+    const std::vector<Vec2>& corners() const { return points; }
+    const std::vector<std::vector<Edge> >& edges() const { return adjacency; }
+
+private:
+    struct Corner {
+        float x, y;
+        float dirX, dirY;       // outward diagonal, away from the corner's own rectangle
+    };
+
+    // the segment from a corner in direction (dx, dy) does not enter its rectangle
+    static bool tangentAt(const Corner& corner, float dx, float dy);
+
+    std::vector<ObstacleRect> rects;    // owned copy, the index points into it
+    ObstacleIndex index;
+    std::vector<Corner> cornerInfo;
+    std::vector<Vec2> points;
+    std::vector<std::vector<Edge> > adjacency;
+};
+
+
+// Same interface as the sampling planners so it can sit next to them in main.cpp
+class VisibilityPlanner {
+public:
+    VisibilityPlanner(sf::Vector2f start, sf::Vector2f goal, const std::vector<sf::RectangleShape>& obstacles);
+
+    bool run();
+
+    float getPathDistance() const { return pathLength; }
+    std::vector<Vec2> getPath() const { return path; }
+
+    void drawPath(sf::RenderWindow& window) const;
+    void drawTree(sf::RenderWindow& window) const;    // the visibility graph
+
+private:
+    Vec2 start;
+    Vec2 goal;
+    std::shared_ptr<const VisibilityGraph> graph;
+    std::vector<Vec2> path;
+    float pathLength;
+    sf::Color color;
+};
@@ -1,6 +1,39 @@
-#include <cstdlib>
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <atomic>
 #include "utils.h"
 
+namespace {
+
+// one generator per thread: rand() may not be called from several threads at once, and the
+// daemon's workers plan concurrently. Every thread gets its own fixed seed, so runs stay
+// reproducible for the same thread order
+std::minstd_rand& engine() {
+    static std::atomic<unsigned> nextSeed(1);
+    thread_local std::minstd_rand generator(nextSeed++);
+    return generator;
+}
+
+// uniform in [0, 1]
+float unit() {
+    std::minstd_rand& g = engine();
+    return static_cast<float>(g() - g.min()) / static_cast<float>(g.max() - g.min());
+}
+
+} // namespace
+
 int randint(int min, int max) {
-    return (rand() % (max - min + 1)) + min;
+    return static_cast<int>(engine()() % static_cast<unsigned>(max - min + 1)) + min;
+}
+
+float randfloat(float min, float max) {
+    return min + (max - min) * unit();
+}
+
+float randnormal(float mean, float stddev) {
+    // u1 in (0, 1] keeps the log finite
+    const float u1 = std::max(unit(), 1e-7f);
+    const float u2 = unit();
+    return mean + stddev * std::sqrt(-2.0f * std::log(u1)) * std::cos(6.28318531f * u2);
 }
@@ -1,15 +1,38 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <cstdint>
+#include "VecN.h"
 
+// random numbers come from a per-thread generator, safe to call from parallel planners
 int randint(int min, int max);
 
-struct Node {
-    sf::Vector2f position;
-    Node* parent;
+// uniform float in [min, max]
+float randfloat(float min, float max);
+
+// normally distributed float (Box-Muller)
+float randnormal(float mean, float stddev);
+
+template <class State>
+struct TreeNode {
+    State position;
+    TreeNode* parent;
     float cost;
+    uint32_t index;     // insertion order in the tree, set by the nearest-neighbour index
 
-    Node(sf::Vector2f pos, Node* par = nullptr, float cost = 0.0f) 
-        : position(pos), parent(par), cost(cost) {}
+    TreeNode(State pos, TreeNode* par = nullptr, float cost = 0.0f) 
+        : position(pos), parent(par), cost(cost), index(0) {}
 };
 
+typedef VecN<2> Vec2;
+typedef TreeNode<Vec2> Node;
+
+inline Vec2 toVec2(sf::Vector2f p) {
+    return Vec2{p.x, p.y};
+}
+
+// projection on the first two components, used to draw any configuration space in the window
+template <int D>
+inline sf::Vector2f toVector2f(const VecN<D>& v) {
+    return sf::Vector2f(v[0], v[1]);
+}
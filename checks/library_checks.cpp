@@ -0,0 +1,1068 @@
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <thread>
+#include <unistd.h>
+#include <sys/un.h>
+#include <queue>
+#include <functional>
+#include <fstream>
+#include <unordered_map>
+#include <atomic>
+#include <chrono>
+#include "../algorithms/Steering.h"
+#include "../algorithms/Scenario.h"
+#include "../algorithms/TiledWorld.h"
+#include "../daemon/PlannerDaemon.h"
+#include "../algorithms/RRTStar.h"
+#include "../algorithms/VisibilityGraph.h"
+#include "../algorithms/GridPlanner.h"
+#include "../algorithms/RRT.h"
+#include "../algorithms/MultiAgent.h"
+#include "../algorithms/TreeSnapshot.h"
+#include "../algorithms/DeltaQueue.h"
+
+// usage: library_checks
+//
+// Exercises the parts of the planning library that the GUI does not reach and
+// checks their results against independent computations. Prints one line per
+// check and exits non-zero when any of them fails.
+
+namespace {
+
+bool report(const char* name, bool ok, const std::string& detail) {
+    std::cout << (ok ? "ok   " : "FAIL ") << name << ": " << detail << "\n";
+    return ok;
+}
+
+const float PI = 3.14159265f;
+
+Pose randomPose(float extent) {
+    return Pose{randfloat(-extent, extent), randfloat(-extent, extent), randfloat(-PI, PI)};
+}
+
+// how far the exact curve from `from` ends from the pose `to`, the heading error
+// counted as the arc it takes to turn it away
+template <class Curve>
+float curveEndError(const Pose& from, const Pose& to, float turningRadius) {
+    const CurvePath path = Curve::shortest(from, to, turningRadius);
+    if (!path.valid()) return std::numeric_limits<float>::max();
+    const Pose end = interpolateCurve(from, path, turningRadius, path.length() * turningRadius);
+    const float dx = end[0] - to[0], dy = end[1] - to[1];
+    return std::max(std::sqrt(dx * dx + dy * dy), turningRadius * std::fabs(wrapAngle(end[2] - to[2])));
+}
+
+// the closed-form curves end on their target and are never longer than the forward-only Dubins
+// curve, and the table stays close to them inside its range
+template <class Curve>
+bool checkCurve(const char* name) {
+    const SteeringTable& table = CurveMetric<Curve>::table();
+    const float rho = table.getTurningRadius();
+    const int samples = 2000;
+    float worstEnd = 0.0f;
+    double relativeError = 0.0;
+    int longerThanDubins = 0, longWords = 0;
+    for (int i = 0; i < samples; ++i) {
+        const Pose from = randomPose(400.0f);
+        Pose to = randomPose(100.0f);
+        to[0] += from[0];
+        to[1] += from[1];
+        worstEnd = std::max(worstEnd, curveEndError<Curve>(from, to, rho));
+        const CurvePath path = Curve::shortest(from, to, rho);
+        if (path.length() > DubinsCurve::shortest(from, to, rho).length() + 1e-3f) ++longerThanDubins;
+        if (path.types[3] != CurvePath::NONE) ++longWords;
+        const float exact = table.exactDistance(from, to);
+        relativeError += std::fabs(table.distance(from, to) - exact) / std::max(exact, 1.0f);
+    }
+    relativeError /= samples;
+
+    std::ostringstream detail;
+    detail << "curves end within " << worstEnd << " of their target over " << samples << " pose pairs, "
+           << longWords << " with four or five segments, " << longerThanDubins << " longer than Dubins, table off by "
+           << 100.0 * relativeError << "% on average";
+    return report(name, worstEnd < 0.5f && longerThanDubins == 0 && relativeError < 0.05, detail.str());
+}
+
+// the planner's path is a chain of free exact curves from the start pose to the goal pose, and
+// the distance it reports is the sum of their exact lengths rather than of the table estimates
+template <class Curve>
+bool checkCurvePlanner(const char* name) {
+    std::vector<sf::RectangleShape> boxes;
+    for (int i = 0; i < 6; ++i) {
+        sf::RectangleShape box(sf::Vector2f(60, 60));
+        box.setPosition(150.0f + 100.0f * i, (i % 2) ? 150.0f : 350.0f);
+        boxes.push_back(box);
+    }
+    const Pose start{50, 300, 0}, goal{750, 300, 0};
+    const CurveCollision<Curve> collision(boxes);
+    CurveRRT<Curve> planner(name, sf::Color::White, start, goal, collision, 20.0f);
+    planner.setBounds(Pose{0, 0, -PI}, Pose{800, 600, PI});
+    planner.setVerbose(false);
+    if (!planner.run(50000)) return report(name, false, "no path in 50000 iterations");
+
+    const std::vector<Pose> path = planner.getPath();
+    const SteeringTable& table = CurveMetric<Curve>::table();
+    const float rho = table.getTurningRadius();
+    int blocked = 0;
+    float worstJoint = 0.0f, exactLength = 0.0f, tableLength = 0.0f;
+    for (size_t i = 1; i < path.size(); ++i) {
+        if (!collision.edgeFree(path[i - 1], path[i])) ++blocked;
+        worstJoint = std::max(worstJoint, curveEndError<Curve>(path[i - 1], path[i], rho));
+        exactLength += Curve::shortest(path[i - 1], path[i], rho).length() * rho;
+        tableLength += table.distance(path[i - 1], path[i]);
+    }
+    const bool joinsEnds = path.front() == start && path.back() == goal;
+    const bool exactReported = std::fabs(planner.getPathDistance() - exactLength) <= 1e-3f * exactLength;
+
+    std::ostringstream detail;
+    detail << path.size() << " poses, " << blocked << " blocked curves, joints within " << worstJoint
+           << ", reported " << planner.getPathDistance() << " for exact curves of " << exactLength
+           << " (table estimate " << tableLength << ")" << (joinsEnds ? "" : ", does not join start and goal");
+    return report(name, joinsEnds && blocked == 0 && worstJoint < 0.5f && exactReported, detail.str());
+}
+
+// a straight drive 16 units from a box: a point clears it, and so would a 30x16 rectangle held
+// level, but the curve checker covers every heading with the disc around the rectangle (radius 17)
+bool checkCurveFootprint() {
+    sf::RectangleShape box(sf::Vector2f(40, 40));
+    box.setPosition(100, 100);
+    const std::vector<sf::RectangleShape> boxes(1, box);
+    const std::vector<sf::ConvexShape> none;
+    const Pose from{0, 84, 0}, to{300, 84, 0};
+    const bool pointFree = CurveCollision<DubinsCurve>(boxes).edgeFree(from, to);
+    const bool rectangleFree = CurveCollision<DubinsCurve>(boxes, none, Footprint::rectangle(30, 16)).edgeFree(from, to);
+
+    std::ostringstream detail;
+    detail << "a drive past a box is " << (pointFree ? "free" : "BLOCKED") << " for a point and "
+           << (rectangleFree ? "FREE" : "blocked") << " for a rectangle that may turn";
+    return report("CurveCollision footprint", pointFree && !rectangleFree, detail.str());
+}
+
+// settings apply until the first table() and are refused after it; threads racing on the
+// first table() all get the same one
+bool checkSteeringTable() {
+    const bool accepted = CurveMetric<ReedsSheppCurve>::configure(20.0f, 160.0f);
+    const SteeringTable* seen[4];
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) threads.push_back(std::thread([&seen, i] { seen[i] = &CurveMetric<ReedsSheppCurve>::table(); }));
+    for (std::thread& thread : threads) thread.join();
+    const bool shared = seen[0] == seen[1] && seen[0] == seen[2] && seen[0] == seen[3];
+    std::cerr << "(the next configure error is expected)\n";
+    const bool refused = !CurveMetric<ReedsSheppCurve>::configure(10.0f, 80.0f);
+
+    std::ostringstream detail;
+    detail << "settings " << (accepted ? "accepted" : "REFUSED") << " before first use and " << (refused ? "refused" : "ACCEPTED")
+           << " after it, racing threads " << (shared ? "share one table" : "got DIFFERENT tables");
+    return report("Steering table", accepted && shared && refused, detail.str());
+}
+
+bool checkSteering() {
+    const bool table = checkSteeringTable();
+    const bool dubins = checkCurve<DubinsCurve>("Dubins curves");
+    const bool reedsShepp = checkCurve<ReedsSheppCurve>("Reeds-Shepp curves");
+    const bool dubinsPlanner = checkCurvePlanner<DubinsCurve>("DubinsRRT");
+    const bool reedsSheppPlanner = checkCurvePlanner<ReedsSheppCurve>("ReedsSheppRRT");
+    const bool footprint = checkCurveFootprint();
+    return table && dubins && reedsShepp && dubinsPlanner && reedsSheppPlanner && footprint;
+}
+
+// what AABBCollision answers for an edge, by scanning every rectangle: the edge's closed
+// bounding box must not touch the inside of any obstacle, so points and axis-parallel
+// edges inside one are blocked too
+bool edgeBlockedByScan(const std::vector<ObstacleRect>& rects, const Vec2& a, const Vec2& b) {
+    const float minX = std::min(a[0], b[0]), maxX = std::max(a[0], b[0]);
+    const float minY = std::min(a[1], b[1]), maxY = std::max(a[1], b[1]);
+    for (const ObstacleRect& o : rects) {
+        if (minX < o.maxX && maxX > o.minX && minY < o.maxY && maxY > o.minY) return true;
+    }
+    return false;
+}
+
+// the collision checker over the mapped rectangles agrees with a scan, through the grid
+// (large maps) and the linear batch test (small maps)
+int collisionMismatches(const ObstacleRect* mapped, const std::vector<ObstacleRect>& rects, int edges) {
+    const AABBCollision collision(mapped, rects.size());
+    std::vector<Vec2> from, to;
+    for (int i = 0; i < edges; ++i) {
+        const Vec2 a{randfloat(0, 2000), randfloat(0, 2000)};
+        // axis-parallel and zero-length edges are as common as any in the planners
+        Vec2 b{a[0] + randfloat(-100, 100), a[1] + randfloat(-100, 100)};
+        if (i % 4 == 1) b[0] = a[0];
+        if (i % 4 == 2) b = a;
+        from.push_back(a);
+        to.push_back(b);
+    }
+    std::vector<char> batch;
+    collision.edgeFreeBatch(from, to, batch);
+    int mismatches = 0;
+    for (int i = 0; i < edges; ++i) {
+        const bool blocked = edgeBlockedByScan(rects, from[i], to[i]);
+        if (collision.edgeFree(from[i], to[i]) == blocked || (batch[i] != 0) == blocked) ++mismatches;
+    }
+    return mismatches;
+}
+
+// Scenario: a saved file maps back to the same header, obstacles and queries; truncated or
+// foreign files are rejected
+bool checkScenario() {
+    const char* path = "library_checks_scenario.bin";
+    std::vector<ObstacleRect> rects;
+    for (int i = 0; i < 600; ++i) {
+        const float x = randfloat(0, 1950), y = randfloat(0, 1950);
+        const ObstacleRect rect = {x, y, x + randfloat(2, 50), y + randfloat(2, 50)};
+        rects.push_back(rect);
+    }
+    std::vector<ScenarioQuery> queries;
+    for (int i = 0; i < 16; ++i) {
+        const ScenarioQuery query = {randfloat(0, 2000), randfloat(0, 2000), randfloat(0, 2000), randfloat(0, 2000)};
+        queries.push_back(query);
+    }
+    if (!Scenario::save(path, 0, 0, 2000, 2000, rects, queries)) return report("Scenario", false, "save failed");
+
+    Scenario scenario;
+    if (!scenario.load(path)) return report("Scenario", false, "load failed");
+    const ScenarioHeader& header = scenario.getHeader();
+    const bool same = header.worldMaxX == 2000 && header.worldMaxY == 2000 &&
+                      scenario.obstacleCount() == rects.size() && scenario.queryCount() == queries.size() &&
+                      std::memcmp(scenario.obstacles(), rects.data(), rects.size() * sizeof(ObstacleRect)) == 0 &&
+                      std::memcmp(scenario.queries(), queries.data(), queries.size() * sizeof(ScenarioQuery)) == 0;
+
+    const int gridMismatches = collisionMismatches(scenario.obstacles(), rects, 20000);
+    const ObstacleRect& first = rects.front();
+    const Vec2 inside{(first.minX + first.maxX) / 2, (first.minY + first.maxY) / 2};
+    const bool pointBlocked = !AABBCollision(scenario.obstacles(), rects.size()).edgeFree(inside, inside);
+    const std::vector<ObstacleRect> few(rects.begin(), rects.begin() + 8);
+    const int linearMismatches = collisionMismatches(scenario.obstacles(), few, 20000);
+
+    // a file cut in the middle of the obstacles, and one with another magic
+    std::vector<char> bytes;
+    FILE* file = std::fopen(path, "rb");
+    for (int c; file && (c = std::fgetc(file)) != EOF; ) bytes.push_back(static_cast<char>(c));
+    if (file) std::fclose(file);
+    std::cerr << "(the next two load errors are expected)\n";
+    bool rejected = true;
+    for (int variant = 0; variant < 2; ++variant) {
+        std::vector<char> broken(bytes);
+        if (variant == 0) broken.resize(bytes.size() / 2);
+        else broken[0] = 'X';
+        file = std::fopen(path, "wb");
+        std::fwrite(broken.data(), 1, broken.size(), file);
+        std::fclose(file);
+        Scenario damaged;
+        rejected = !damaged.load(path) && rejected;
+    }
+
+    std::ostringstream detail;
+    detail << (same ? "round trip exact" : "round trip DIFFERS") << ", " << gridMismatches << " grid and "
+           << linearMismatches << " linear edge checks of 20000 disagree with a scan, damaged files "
+           << (rejected ? "rejected" : "ACCEPTED");
+    if (!pointBlocked) detail << ", a point inside an obstacle is FREE";
+    return report("Scenario", same && gridMismatches == 0 && linearMismatches == 0 && rejected && pointBlocked,
+                  detail.str());
+}
+
+// the path joins from and to through free segments and is as long as claimed
+bool pathValid(const std::vector<Vec2>& path, const Vec2& from, const Vec2& to, float cost, const AABBCollision& collision) {
+    if (path.size() < 2 || squaredDistance(path.front(), from) > 1e-6f || squaredDistance(path.back(), to) > 1e-6f) return false;
+    float length = 0.0f;
+    for (size_t i = 1; i < path.size(); ++i) {
+        if (!collision.edgeFree(path[i - 1], path[i])) return false;
+        length += std::sqrt(squaredDistance(path[i - 1], path[i]));
+    }
+    return std::fabs(length - cost) <= 1e-3f * std::max(1.0f, cost);
+}
+
+// TiledWorld: with a cache far smaller than the world, edge checks along a walk across it
+// agree with one AABBCollision over all obstacles, also from four threads sharing the cache,
+// and a tiled RRT finds a path that is free in the flat world too. Below 16 cached tiles
+// prefetching maps nothing.
+bool checkTiledWorld() {
+    const char* directory = "library_checks_tiles";
+    std::vector<ObstacleRect> rects;
+    for (int i = 0; i < 5000; ++i) {
+        const float x = randfloat(0, 10000), y = randfloat(0, 10000);
+        const ObstacleRect rect = {x, y, x + randfloat(5, 65), y + randfloat(5, 65)};
+        rects.push_back(rect);
+    }
+    if (!TiledWorld::build(directory, rects.data(), rects.size(), 0, 0, 10000, 10000, 1000)) {
+        return report("TiledWorld", false, "build failed");
+    }
+    TiledWorld world(16);
+    if (!world.open(directory)) return report("TiledWorld", false, "open failed");
+    const AABBCollision flat(rects.data(), rects.size());
+
+    // edges from a point wandering over the whole world, the way a tree reaches new tiles
+    int mismatches = 0;
+    Vec2 a{5000, 5000};
+    for (int i = 0; i < 20000; ++i) {
+        const Vec2 b{std::min(9999.0f, std::max(0.0f, a[0] + randfloat(-150, 150))),
+                     std::min(9999.0f, std::max(0.0f, a[1] + randfloat(-150, 150)))};
+        if (world.edgeFree(a, b) != flat.edgeFree(a, b)) ++mismatches;
+        world.prefetchAround(b);
+        a = b;
+    }
+
+    std::atomic<int> sharedMismatches(0);
+    std::vector<std::thread> walkers;
+    for (int t = 0; t < 4; ++t) {
+        walkers.push_back(std::thread([&world, &flat, &sharedMismatches, t] {
+            const TiledCollision collision(world);
+            Vec2 p{2000.0f * (t + 1), 5000.0f};
+            for (int i = 0; i < 5000; ++i) {
+                const Vec2 q{std::min(9999.0f, std::max(0.0f, p[0] + randfloat(-150, 150))),
+                             std::min(9999.0f, std::max(0.0f, p[1] + randfloat(-150, 150)))};
+                if (collision.edgeFree(p, q) != flat.edgeFree(p, q)) ++sharedMismatches;
+                p = q;
+            }
+        }));
+    }
+    for (std::thread& walker : walkers) walker.join();
+
+    TiledWorld small(9);
+    const bool smallOpen = small.open(directory);
+    small.prefetchAround(Vec2{5000, 5000});
+    const bool noPrefetch = smallOpen && small.tileLoads() == 0;
+
+    // random obstacles may cover the usual corners, so move the ends until they are free
+    Vec2 start{100, 100}, goal{2500, 2500};
+    while (!flat.edgeFree(start, start)) start[0] += 10;
+    while (!flat.edgeFree(goal, goal)) goal[0] += 10;
+    TiledRRT planner("TiledRRT", sf::Color::Yellow, start, goal, TiledCollision(world), 20.0f);
+    planner.setBounds(world.getLower(), Vec2{3000, 3000});
+    planner.setVerbose(false);
+    const bool found = planner.run(50000);
+    const bool valid = found && pathValid(planner.getPath(), planner.getStart(), planner.getGoal(), planner.getPathDistance(), flat);
+
+    std::ostringstream detail;
+    detail << mismatches << " of 20000 edges disagree with the flat map, " << sharedMismatches << " of 20000 from four threads, path "
+           << (found ? (valid ? "valid" : "INVALID") : "not found") << ", " << world.tileLoads() << " tile loads, "
+           << world.residentTiles() << " resident, " << (noPrefetch ? "no prefetch" : "PREFETCH") << " with 9 tiles";
+    return report("TiledWorld", mismatches == 0 && sharedMismatches == 0 && valid && world.residentTiles() <= 16 && noPrefetch,
+                  detail.str());
+}
+
+int connectTo(const char* socketPath) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool readMessage(int fd, MessageHeader& header, std::vector<char>& payload) {
+    if (!recvAll(fd, &header, sizeof(header))) return false;
+    payload.resize(header.length);
+    return header.length == 0 || recvAll(fd, payload.data(), header.length);
+}
+
+// PlannerDaemon: a client loads a map and pipelines plans with every algorithm; each
+// PATH is a free path between the requested ends, and a plan on an unknown map is an ERROR.
+// A goal inside an obstacle comes back PATH_NOT_FOUND with its whole budget spent, a missing
+// map file is an ERROR, and no worker takes more than its share of the burst.
+bool checkDaemon() {
+    const char* mapPath = "library_checks_daemon.bin";
+    const char* socketPath = "library_checks.sock";
+    std::vector<ObstacleRect> rects;
+    for (int i = 0; i < 40; ++i) {
+        const float x = randfloat(100, 680), y = randfloat(0, 560);
+        const ObstacleRect rect = {x, y, x + 40, y + 40};
+        rects.push_back(rect);
+    }
+    const AABBCollision collision(rects.data(), rects.size());
+    std::vector<ScenarioQuery> queries;
+    while (queries.size() < 24) {
+        const Vec2 start{randfloat(0, 90), randfloat(0, 600)}, goal{randfloat(710, 800), randfloat(0, 600)};
+        const ScenarioQuery query = {start[0], start[1], goal[0], goal[1]};
+        if (collision.edgeFree(start, start) && collision.edgeFree(goal, goal)) queries.push_back(query);
+    }
+    if (!Scenario::save(mapPath, 0, 0, 800, 600, rects, queries)) return report("PlannerDaemon", false, "save failed");
+
+    PlannerDaemon daemon(socketPath, 4, 8);
+    if (!daemon.start()) return report("PlannerDaemon", false, "start failed");
+    std::thread server(&PlannerDaemon::serve, &daemon);
+
+    // a client that floods LOAD_MAP and never reads its replies must not hold up the others
+    const int stalled = connectTo(socketPath);
+    std::string flood;
+    for (int i = 0; i < 200000; ++i) encodeMessage(flood, MSG_LOAD_MAP, mapPath, std::strlen(mapPath));
+    std::thread flooder([stalled, &flood] { sendAll(stalled, flood.data(), flood.size()); });
+
+    const int fd = connectTo(socketPath);
+    const timeval timeout = {20, 0};
+    if (fd >= 0) setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    MessageHeader header;
+    std::vector<char> payload;
+    MapLoadedReply map = {0, 0, 0};
+    bool loaded = fd >= 0 && sendMessage(fd, MSG_LOAD_MAP, mapPath, std::strlen(mapPath)) &&
+                  readMessage(fd, header, payload) && header.type == MSG_MAP_LOADED;
+    if (loaded) std::memcpy(&map, payload.data(), sizeof(map));
+    loaded = loaded && map.obstacleCount == rects.size();
+
+    std::cerr << "(the next load error is expected)\n";
+    const char* missingPath = "library_checks_missing.bin";
+    ErrorReply missing = {0, 0};
+    if (loaded && sendMessage(fd, MSG_LOAD_MAP, missingPath, std::strlen(missingPath)) &&
+        readMessage(fd, header, payload) && header.type == MSG_ERROR) {
+        std::memcpy(&missing, payload.data(), sizeof(missing));
+    }
+
+    uint32_t sent = 0;
+    for (size_t q = 0; loaded && q < queries.size(); ++q) {
+        const PlanRequest request = {sent++, map.mapId, static_cast<uint32_t>(q % 3), 0, 10.0f,
+                                     queries[q].startX, queries[q].startY, queries[q].goalX, queries[q].goalY};
+        loaded = sendMessage(fd, MSG_PLAN, &request, sizeof(request));
+    }
+    const PlanRequest buried = {sent++, map.mapId, ALG_RRT, 300, 10.0f, queries[0].startX, queries[0].startY,
+                                rects[0].minX + 20, rects[0].minY + 20};
+    const PlanRequest unknown = {sent++, map.mapId + 1, ALG_RRT, 0, 10.0f, 10, 10, 790, 590};
+    loaded = loaded && sendMessage(fd, MSG_PLAN, &buried, sizeof(buried)) && sendMessage(fd, MSG_PLAN, &unknown, sizeof(unknown));
+
+    int found = 0, invalid = 0, errors = 0;
+    bool budgetReported = false;
+    uint32_t largestBatch = 0;
+    for (uint32_t received = 0; loaded && received < sent; ++received) {
+        if (!readMessage(fd, header, payload)) {
+            loaded = false;
+            break;
+        }
+        if (header.type == MSG_ERROR) {
+            ErrorReply error;
+            std::memcpy(&error, payload.data(), sizeof(error));
+            errors += error.requestId == unknown.requestId && error.code == ERR_UNKNOWN_MAP;
+            continue;
+        }
+        PathReply reply;
+        std::memcpy(&reply, payload.data(), sizeof(reply));
+        largestBatch = std::max(largestBatch, reply.batchSize);
+        if (reply.requestId == buried.requestId) {
+            budgetReported = reply.status == PATH_NOT_FOUND && reply.iterations == buried.maxIterations;
+            continue;
+        }
+        if (reply.status != PATH_FOUND || reply.requestId >= queries.size()) continue;
+        ++found;
+        std::vector<Vec2> path(reply.pointCount);
+        std::memcpy(path.data(), payload.data() + sizeof(reply), path.size() * sizeof(Vec2));
+        const ScenarioQuery& query = queries[reply.requestId];
+        if (!pathValid(path, Vec2{query.startX, query.startY}, Vec2{query.goalX, query.goalY}, reply.distance, collision)) ++invalid;
+    }
+    if (fd >= 0) close(fd);
+    shutdown(stalled, SHUT_RDWR);
+    flooder.join();
+    close(stalled);
+    daemon.stop();
+    server.join();
+
+    // 4 workers share the queries sent to the map
+    const uint32_t fairShare = (queries.size() + 1 + 3) / 4;
+    const bool missingRejected = missing.code == ERR_MAP_LOAD_FAILED;
+    std::ostringstream detail;
+    detail << found << "/" << queries.size() << " paths found next to a stalled client, " << invalid << " invalid, unknown map "
+           << (errors == 1 ? "rejected" : "NOT rejected") << ", missing file " << (missingRejected ? "rejected" : "NOT rejected")
+           << ", unreachable goal " << (budgetReported ? "reports its budget" : "does NOT report its budget")
+           << ", batches of up to " << largestBatch << (loaded ? "" : ", connection lost");
+    return report("PlannerDaemon", loaded && found == static_cast<int>(queries.size()) && invalid == 0 && errors == 1 &&
+                  missingRejected && budgetReported && largestBatch <= fairShare, detail.str());
+}
+
+// field of 20x20 boxes, kept clear of the left edge where the start is
+std::vector<sf::RectangleShape> randomBoxes(int count) {
+    std::vector<sf::RectangleShape> boxes;
+    for (int i = 0; i < count; ++i) {
+        sf::RectangleShape box(sf::Vector2f(20, 20));
+        box.setPosition(randfloat(40, 780), randfloat(0, 580));
+        boxes.push_back(box);
+    }
+    return boxes;
+}
+
+bool insideAny(const std::vector<sf::RectangleShape>& boxes, const Vec2& p) {
+    for (const sf::RectangleShape& box : boxes) {
+        if (box.getGlobalBounds().contains(p[0], p[1])) return true;
+    }
+    return false;
+}
+
+// runMultiGoal: every free goal is reached through a valid path, and over several maps the
+// shared tree costs about what planning each goal on its own does. One map alone says
+// little: all its goals hang off the same tree, so a detour near the root is paid by every
+// goal behind it.
+bool checkMultiGoal() {
+    const int maps = 5, goalsPerMap = 12;
+    int reached = 0, invalid = 0, compared = 0;
+    float multiCost = 0.0f, singleCost = 0.0f;
+    for (int m = 0; m < maps; ++m) {
+        const std::vector<sf::RectangleShape> boxes = randomBoxes(60);
+        std::vector<Vec2> goals;
+        while (goals.size() < static_cast<size_t>(goalsPerMap)) {
+            const Vec2 goal{randfloat(0, 800), randfloat(0, 600)};
+            if (!insideAny(boxes, goal)) goals.push_back(goal);
+        }
+
+        RRTStar planner(sf::Vector2f(10, 300), sf::Vector2f(790, 300), boxes);
+        planner.setVerbose(false);
+        std::vector<RRTStar::GoalPath> results;
+        reached += planner.runMultiGoal(goals, results);
+
+        for (size_t g = 0; g < goals.size(); ++g) {
+            if (!results[g].reached) continue;
+            if (!pathValid(results[g].path, planner.getStart(), goals[g], results[g].cost, planner.collision())) ++invalid;
+
+            RRTStar single(sf::Vector2f(10, 300), toVector2f(goals[g]), boxes);
+            single.setVerbose(false);
+            if (single.run()) {
+                ++compared;
+                multiCost += results[g].cost;
+                singleCost += single.getPathDistance();
+            }
+        }
+    }
+
+    const float ratio = multiCost / std::max(singleCost, 1.0f);
+    std::ostringstream detail;
+    detail << reached << "/" << maps * goalsPerMap << " goals reached over " << maps << " maps, " << invalid
+           << " invalid paths, cost " << ratio << "x planning the " << compared << " goals one by one";
+    return report("runMultiGoal", reached == maps * goalsPerMap && invalid == 0 && ratio < 1.25f, detail.str());
+}
+
+bool pointFree(const std::vector<ObstacleRect>& rects, const Vec2& p) {
+    for (const ObstacleRect& o : rects) {
+        if (p[0] > o.minX && p[0] < o.maxX && p[1] > o.minY && p[1] < o.maxY) return false;
+    }
+    return true;
+}
+
+// shortest path length over the full visibility graph (every free corner, every free
+// segment, linear obstacle scan), or infinity
+float shortestByDijkstra(const std::vector<ObstacleRect>& rects, const Vec2& start, const Vec2& goal) {
+    const ObstacleIndex linear(rects.data(), rects.size(), 1e9f);
+    std::vector<Vec2> points{start, goal};
+    for (const ObstacleRect& o : rects) {
+        const Vec2 corners[4] = {Vec2{o.minX, o.minY}, Vec2{o.maxX, o.minY}, Vec2{o.minX, o.maxY}, Vec2{o.maxX, o.maxY}};
+        for (const Vec2& corner : corners) {
+            if (pointFree(rects, corner)) points.push_back(corner);
+        }
+    }
+    std::vector<float> distance(points.size(), std::numeric_limits<float>::infinity());
+    std::vector<char> done(points.size(), 0);
+    distance[0] = 0.0f;
+    for (;;) {
+        int u = -1;
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (!done[i] && (u < 0 || distance[i] < distance[u])) u = static_cast<int>(i);
+        }
+        if (u < 0 || u == 1 || distance[u] == std::numeric_limits<float>::infinity()) break;
+        done[u] = 1;
+        for (size_t v = 0; v < points.size(); ++v) {
+            const float through = distance[u] + std::sqrt(squaredDistance(points[u], points[v]));
+            if (!done[v] && through < distance[v] &&
+                linear.segmentFree(points[u][0], points[u][1], points[v][0], points[v][1])) {
+                distance[v] = through;
+            }
+        }
+    }
+    return distance[1];
+}
+
+// VisibilityGraph: on random overlapping boxes the A* answer matches Dijkstra over the full
+// visibility graph, paths are free, buried corners are left out, and queries starting or
+// ending inside an obstacle fail; the grid segment test agrees with a linear scan
+bool checkVisibilityGraph() {
+    int queries = 0, wrong = 0, blocked = 0, badCorners = 0, insideEnds = 0;
+    for (int m = 0; m < 20; ++m) {
+        std::vector<ObstacleRect> rects;
+        const int count = 20 + m * 3;
+        for (int i = 0; i < count; ++i) {
+            const float x = randfloat(0, 760), y = randfloat(0, 560);
+            const ObstacleRect rect = {x, y, x + randfloat(5, 85), y + randfloat(5, 85)};
+            rects.push_back(rect);
+        }
+        const VisibilityGraph graph(rects);
+        size_t freeCorners = 0;
+        for (const ObstacleRect& o : rects) {
+            freeCorners += pointFree(rects, Vec2{o.minX, o.minY}) + pointFree(rects, Vec2{o.maxX, o.minY}) +
+                           pointFree(rects, Vec2{o.minX, o.maxY}) + pointFree(rects, Vec2{o.maxX, o.maxY});
+        }
+        if (graph.corners().size() != freeCorners) ++badCorners;
+
+        const ObstacleIndex linear(rects.data(), rects.size(), 1e9f);
+        for (int q = 0; q < 10; ++q, ++queries) {
+            const Vec2 start{randfloat(0, 800), randfloat(0, 600)}, goal{randfloat(0, 800), randfloat(0, 600)};
+            std::vector<Vec2> path;
+            float cost = 0.0f;
+            const bool found = graph.shortestPath(start, goal, path, cost);
+            const bool endsFree = pointFree(rects, start) && pointFree(rects, goal);
+            insideEnds += !endsFree;
+            const float reference = endsFree ? shortestByDijkstra(rects, start, goal) : std::numeric_limits<float>::infinity();
+            const bool reachable = reference != std::numeric_limits<float>::infinity();
+            if (found != reachable || (found && std::fabs(cost - reference) > 1e-2f * std::max(1.0f, reference))) ++wrong;
+            for (size_t i = 1; found && i < path.size(); ++i) {
+                if (!linear.segmentFree(path[i - 1][0], path[i - 1][1], path[i][0], path[i][1])) ++blocked;
+            }
+        }
+    }
+
+    std::vector<ObstacleRect> rects;
+    for (int i = 0; i < 3000; ++i) {
+        const float x = randfloat(0, 5000), y = randfloat(0, 5000);
+        const ObstacleRect rect = {x, y, x + randfloat(10, 50), y + randfloat(10, 50)};
+        rects.push_back(rect);
+    }
+    const ObstacleIndex grid(rects.data(), rects.size()), linear(rects.data(), rects.size(), 1e9f);
+    int segmentMismatches = 0;
+    for (int i = 0; i < 20000; ++i) {
+        const float x1 = randfloat(0, 5000), y1 = randfloat(0, 5000), x2 = randfloat(0, 5000), y2 = randfloat(0, 5000);
+        if (grid.segmentFree(x1, y1, x2, y2) != linear.segmentFree(x1, y1, x2, y2)) ++segmentMismatches;
+    }
+
+    std::ostringstream detail;
+    detail << wrong << " of " << queries << " queries differ from Dijkstra (" << insideEnds << " with an end inside an obstacle), "
+           << blocked << " blocked segments, " << badCorners << " maps with buried corners kept, " << segmentMismatches
+           << " of 20000 grid segment tests differ from a scan";
+    return report("VisibilityGraph", wrong == 0 && blocked == 0 && badCorners == 0 && segmentMismatches == 0, detail.str());
+}
+
+// GridPlanner: on random maps and resolutions, JPS reaches exactly the goals that Dijkstra
+// over the same rasterized 8-connected grid (no corner cutting) reaches, at the same cost
+bool checkGridPlanner() {
+    typedef std::pair<float, int> Entry;
+    int queries = 0, wrong = 0;
+    for (int m = 0; m < 20; ++m) {
+        std::vector<sf::RectangleShape> boxes;
+        for (int i = 0, count = 10 + m * 4; i < count; ++i) {
+            sf::RectangleShape box(sf::Vector2f(randfloat(5, 125), randfloat(5, 125)));
+            box.setPosition(randfloat(0, 780), randfloat(0, 580));
+            boxes.push_back(box);
+        }
+        const float resolution = 4.0f + m % 6;
+        GridPlanner grid(sf::Vector2f(0, 0), sf::Vector2f(1, 1), boxes, resolution);
+
+        // the same cells the planner blocks: every cell a rectangle overlaps
+        const int width = static_cast<int>(std::ceil(800 / resolution)), height = static_cast<int>(std::ceil(600 / resolution));
+        std::vector<char> cells(width * height, 0);
+        for (const ObstacleRect& o : toObstacleRects(boxes)) {
+            for (int y = std::max(0, static_cast<int>(std::floor(o.minY / resolution)));
+                 y <= std::min(height - 1, static_cast<int>(std::ceil(o.maxY / resolution)) - 1); ++y) {
+                for (int x = std::max(0, static_cast<int>(std::floor(o.minX / resolution)));
+                     x <= std::min(width - 1, static_cast<int>(std::ceil(o.maxX / resolution)) - 1); ++x) {
+                    cells[y * width + x] = 1;
+                }
+            }
+        }
+        auto blocked = [&](int x, int y) { return x < 0 || y < 0 || x >= width || y >= height || cells[y * width + x]; };
+
+        for (int q = 0; q < 10; ++q, ++queries) {
+            const Vec2 start{randfloat(0, 799), randfloat(0, 599)}, goal{randfloat(0, 799), randfloat(0, 599)};
+            const bool found = grid.plan(start, goal);
+
+            const int sx = static_cast<int>(start[0] / resolution), sy = static_cast<int>(start[1] / resolution);
+            const int target = static_cast<int>(goal[1] / resolution) * width + static_cast<int>(goal[0] / resolution);
+            std::vector<float> distance(width * height, std::numeric_limits<float>::infinity());
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > open;
+            float reference = -1.0f;
+            if (!blocked(sx, sy) && !cells[target]) {
+                distance[sy * width + sx] = 0.0f;
+                open.push(Entry(0.0f, sy * width + sx));
+            }
+            while (!open.empty()) {
+                const Entry top = open.top();
+                open.pop();
+                const int cell = top.second, x = cell % width, y = cell / width;
+                if (top.first > distance[cell]) continue;
+                if (cell == target) {
+                    reference = top.first;
+                    break;
+                }
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        if ((!dx && !dy) || blocked(x + dx, y + dy)) continue;
+                        if (dx && dy && (blocked(x + dx, y) || blocked(x, y + dy))) continue;
+                        const int next = (y + dy) * width + x + dx;
+                        const float through = top.first + ((dx && dy) ? 1.41421356f : 1.0f);
+                        if (through < distance[next]) {
+                            distance[next] = through;
+                            open.push(Entry(through, next));
+                        }
+                    }
+                }
+            }
+
+            if (found != (reference >= 0.0f)) {
+                ++wrong;
+                continue;
+            }
+            if (!found) continue;
+            // the path is start, the cell centres, goal: compare the part between cell centres, in cells
+            const std::vector<Vec2> path = grid.getPath();
+            float length = 0.0f;
+            for (size_t i = 2; i + 1 < path.size(); ++i) length += std::sqrt(squaredDistance(path[i - 1], path[i]));
+            if (std::fabs(length / resolution - reference) > 1e-2f * std::max(1.0f, reference)) ++wrong;
+        }
+    }
+
+    std::ostringstream detail;
+    detail << wrong << " of " << queries << " queries differ from Dijkstra on the same grid";
+    return report("GridPlanner", wrong == 0, detail.str());
+}
+
+// two walls leaving a 12 px wide, 200 px long gap at y 400..412
+std::vector<sf::RectangleShape> corridorWalls() {
+    std::vector<sf::RectangleShape> walls(2);
+    walls[0].setSize(sf::Vector2f(200, 400));
+    walls[0].setPosition(200, 0);
+    walls[1].setSize(sf::Vector2f(200, 188));
+    walls[1].setPosition(200, 412);
+    return walls;
+}
+
+// median iterations to the first path through the corridor, over runs; -1 when a run fails
+template <class Sampler>
+int medianIterations(const AABBCollision& collision, int runs) {
+    std::vector<int> iterations;
+    for (int r = 0; r < runs; ++r) {
+        RRTSampled<Sampler> planner("sampled", sf::Color::White, Vec2{50, 300}, Vec2{750, 300}, collision, 10.0f);
+        planner.setBounds(Vec2{0, 0}, Vec2{800, 600});
+        planner.setVerbose(false);
+        if (!planner.run(200000)) return -1;
+        iterations.push_back(planner.getIterations());
+    }
+    std::sort(iterations.begin(), iterations.end());
+    return iterations[iterations.size() / 2];
+}
+
+// share of samples that are free and within two steps of a wall, and that are inside the gap
+template <class Sampler, class P>
+void sampleShares(const P& planner, int samples, float& nearWall, float& inGap) {
+    Sampler sampler;
+    int near = 0, gap = 0;
+    for (int i = 0; i < samples; ++i) {
+        const Vec2 s = sampler.sample(planner);
+        if (!planner.collision().edgeFree(s, s)) continue;
+        near += s[0] > 180 && s[0] < 420;
+        gap += s[0] > 200 && s[0] < 400 && s[1] > 400 && s[1] < 412;
+    }
+    nearWall = static_cast<float>(near) / samples;
+    inGap = static_cast<float>(gap) / samples;
+}
+
+// Samplers: Gaussian samples gather along the walls and bridge samples inside the gap, far
+// above the uniform share; every sampler gets through the corridor, the adaptive one in
+// fewer iterations than uniform
+bool checkSamplers() {
+    const std::vector<sf::RectangleShape> walls = corridorWalls();
+    const AABBCollision collision(walls);
+    RRTSampled<UniformSampler> planner("sampled", sf::Color::White, Vec2{50, 300}, Vec2{750, 300}, collision, 10.0f);
+    planner.setBounds(Vec2{0, 0}, Vec2{800, 600});
+    float uniformNear, uniformGap, gaussianNear, gaussianGap, bridgeNear, bridgeGap;
+    sampleShares<UniformSampler>(planner, 20000, uniformNear, uniformGap);
+    sampleShares<GaussianSampler>(planner, 20000, gaussianNear, gaussianGap);
+    sampleShares<BridgeSampler>(planner, 20000, bridgeNear, bridgeGap);
+
+    const int runs = 40;
+    const int medians[] = {medianIterations<UniformSampler>(collision, runs), medianIterations<GaussianSampler>(collision, runs),
+                           medianIterations<BridgeSampler>(collision, runs), medianIterations<AdaptiveSampler<> >(collision, runs),
+                           medianIterations<GoalBiasedSampler<> >(collision, runs),
+                           medianIterations<GoalBiasedSampler<BridgeSampler> >(collision, runs)};
+    const char* names[] = {"uniform", "Gaussian", "bridge", "adaptive", "goal-biased", "bridge + goal bias"};
+    bool solved = true;
+    std::ostringstream detail;
+    detail << "near the walls " << 100 * gaussianNear << "% Gaussian vs " << 100 * uniformNear << "% uniform, in the gap "
+           << 100 * bridgeGap << "% bridge vs " << 100 * uniformGap << "% uniform; median iterations over " << runs << " runs:";
+    for (int s = 0; s < 6; ++s) {
+        detail << (s ? ", " : " ") << names[s] << " " << medians[s];
+        solved = solved && medians[s] > 0;
+    }
+    return report("Samplers", gaussianNear > 3 * uniformNear && bridgeGap > 5 * uniformGap && solved && medians[3] < medians[0], detail.str());
+}
+
+// (x, y) of a space-time path at time t; before the start and after the end the agent stands still
+Vec2 positionAt(const std::vector<SpaceTime>& path, float t) {
+    for (size_t i = 1; i < path.size(); ++i) {
+        if (t > path[i][2]) continue;
+        const float dt = path[i][2] - path[i - 1][2];
+        const float u = dt > 0.0f ? std::max(0.0f, (t - path[i - 1][2]) / dt) : 0.0f;
+        return Vec2{path[i - 1][0] + (path[i][0] - path[i - 1][0]) * u, path[i - 1][1] + (path[i][1] - path[i - 1][1]) * u};
+    }
+    return Vec2{path.back()[0], path.back()[1]};
+}
+
+// FleetPlanner: 16 agents crossing a field of staggered walls, planned in parallel waves.
+// Prioritized planning may leave an agent without a path, but at least three in four get
+// one. Each path must respect the speed limit and miss the walls inflated by the agent
+// radius, and no two agents may come closer than two radii at any time (sampled every
+// 0.25 time units).
+bool checkFleet() {
+    const float radius = 6.0f;
+    const int agents = 16;
+    std::vector<ObstacleRect> walls, inflated;
+    for (int i = 0; i < 12; ++i) {
+        const float x = 60.0f + i * 60.0f, y = (i % 2) ? 100.0f : 350.0f;
+        const ObstacleRect wall = {x, y, x + 25, y + 150};
+        const ObstacleRect grown = {wall.minX - radius, wall.minY - radius, wall.maxX + radius, wall.maxY + radius};
+        walls.push_back(wall);
+        inflated.push_back(grown);
+    }
+    const AABBCollision statics(inflated.data(), inflated.size());
+
+    std::vector<AgentTask> tasks;
+    for (int i = 0; i < agents; ++i) {
+        const float offset = 560.0f * i / agents;
+        const AgentTask task = {Vec2{20, 20 + offset}, Vec2{780, 580 - offset}};
+        tasks.push_back(task);
+    }
+    FleetPlanner fleet(walls.data(), walls.size(), radius, 10.0f);
+    const int found = fleet.plan(tasks, 20000, 0);
+    const std::vector<AgentPlan>& plans = fleet.getPlans();
+
+    int speeding = 0, blocked = 0, conflicts = 0;
+    for (int a = 0; a < agents; ++a) {
+        if (!plans[a].found) continue;
+        const std::vector<SpaceTime>& path = plans[a].path;
+        for (size_t i = 1; i < path.size(); ++i) {
+            if (!SpaceTimeMetric::causal(path[i - 1], path[i])) ++speeding;
+            if (!statics.edgeFree(Vec2{path[i - 1][0], path[i - 1][1]}, Vec2{path[i][0], path[i][1]})) ++blocked;
+        }
+        for (int b = 0; b < a; ++b) {
+            if (!plans[b].found) continue;
+            const float end = std::max(path.back()[2], plans[b].path.back()[2]);
+            for (float t = 0.0f; t <= end; t += 0.25f) {
+                if (squaredDistance(positionAt(path, t), positionAt(plans[b].path, t)) < 4.0f * radius * radius * 0.99f) {
+                    ++conflicts;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::ostringstream detail;
+    detail << found << "/" << agents << " agents planned, " << conflicts << " conflicting pairs, "
+           << speeding << " segments over speed, " << blocked << " through a wall";
+    return report("FleetPlanner", 4 * found >= 3 * agents && conflicts == 0 && speeding == 0 && blocked == 0, detail.str());
+}
+
+// TreeSnapshot: a recorded RRT takes under 10 bytes per node and loads back with the same
+// parents, positions and costs within one quantum, and the same path; a file cut short
+// still loads a consistent prefix
+bool checkTreeSnapshot() {
+    const char* path = "library_checks_tree.snap";
+    std::vector<ObstacleRect> rects;
+    for (int i = 0; i < 40; ++i) {
+        const float x = randfloat(50, 720), y = randfloat(50, 520);
+        const ObstacleRect rect = {x, y, x + 30, y + 30};
+        rects.push_back(rect);
+    }
+    const AABBCollision collision(rects.data(), rects.size());
+    // short steps, so the tree spans several chunks
+    RRTBase planner("RRT", sf::Color::White, Vec2{10, 10}, Vec2{790, 590}, collision, 4.0f);
+    planner.setBounds(Vec2{0, 0}, Vec2{800, 600});
+    planner.setVerbose(false);
+    TreeRecorder recorder;
+    if (!recorder.open(path, 2)) return report("TreeSnapshot", false, "open failed");
+    planner.setRecorder(&recorder);
+    const bool found = planner.run(100000);
+    recorder.close();
+
+    TreeSnapshot snapshot;
+    if (!snapshot.load(path)) return report("TreeSnapshot", false, "load failed");
+    const auto& nodes = planner.index().all();
+    std::unordered_map<const void*, int> record;
+    for (size_t i = 0; i < nodes.size(); ++i) record[nodes[i]] = static_cast<int>(i);
+    const float quantum = 1.0f / 16.0f;
+    int wrongParents = 0, wrongValues = 0;
+    for (size_t i = 0; i < nodes.size() && i < snapshot.size(); ++i) {
+        if ((nodes[i]->parent ? record[nodes[i]->parent] : -1) != snapshot.parent(i)) ++wrongParents;
+        if (std::fabs(nodes[i]->position[0] - snapshot.position(i)[0]) > quantum ||
+            std::fabs(nodes[i]->position[1] - snapshot.position(i)[1]) > quantum ||
+            std::fabs(nodes[i]->cost - snapshot.cost(i)) > quantum) {
+            ++wrongValues;
+        }
+    }
+    const std::vector<Vec2> states = planner.getPath();
+    bool samePath = snapshot.path().size() == 2 * states.size();
+    for (size_t i = 0; samePath && i < states.size(); ++i) {
+        samePath = std::fabs(snapshot.path()[2 * i] - states[i][0]) <= quantum &&
+                   std::fabs(snapshot.path()[2 * i + 1] - states[i][1]) <= quantum;
+    }
+    const double bytesPerNode = static_cast<double>(recorder.bytesWritten()) / nodes.size();
+
+    // drop the path chunk and half of the last node chunk
+    std::vector<char> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() * 3 / 4));
+    }
+    TreeSnapshot cut;
+    bool prefix = cut.load(path) && cut.size() > 0 && cut.size() < nodes.size() && cut.path().empty();
+    for (size_t i = 1; prefix && i < cut.size(); ++i) {
+        prefix = cut.parent(i) == snapshot.parent(i) && cut.parent(i) < static_cast<int32_t>(i);
+    }
+
+    // neither side accepts more than MAX_DIMENSION components
+    std::cerr << "(the next two dimension errors are expected)\n";
+    TreeRecorder wide;
+    const bool wideRefused = !wide.open("library_checks_wide.snap", MAX_DIMENSION + 1);
+    bytes[8] = static_cast<char>(MAX_DIMENSION + 1);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    TreeSnapshot wideSnapshot;
+    const bool wideRejected = !wideSnapshot.load(path);
+
+    std::ostringstream detail;
+    detail << nodes.size() << " nodes as " << snapshot.size() << " records (" << bytesPerNode << " B/node), " << wrongParents
+           << " wrong parents, " << wrongValues << " off by more than a quantum, path " << (samePath ? "kept" : "DIFFERS")
+           << ", a cut file loads " << (prefix ? "a consistent prefix" : "BADLY") << ", more than " << MAX_DIMENSION
+           << " dimensions " << (wideRefused && wideRejected ? "refused" : "ACCEPTED");
+    return report("TreeSnapshot", found && snapshot.size() == nodes.size() && bytesPerNode < 10.0 && wrongParents == 0 &&
+                  wrongValues == 0 && samePath && prefix && wideRefused && wideRejected, detail.str());
+}
+
+DeltaQueue liveQueue;
+
+// DeltaQueue: five RRTs publish on a planning thread while this one drains, as the GUI
+// does; every tree edge and path edge arrives once, in order, and nothing is dropped.
+// Stop then cancels a planner with an unreachable goal while it is streaming.
+bool checkLiveView() {
+    std::vector<ObstacleRect> rects;
+    for (int i = 0; i < 40; ++i) {
+        const float x = randfloat(50, 720), y = randfloat(50, 520);
+        const ObstacleRect rect = {x, y, x + 30, y + 30};
+        rects.push_back(rect);
+    }
+    const AABBCollision collision(rects.data(), rects.size());
+
+    const int runs = 5;
+    std::vector<std::vector<TreeDelta> > expected(runs);
+    size_t dropped = 0;
+    std::atomic<bool> done(false);
+    std::thread producer([&] {
+        for (int r = 0; r < runs; ++r) {
+            RRTBase planner("RRT", sf::Color::White, Vec2{10, 10}, Vec2{790, 590}, collision, 10.0f);
+            planner.setBounds(Vec2{0, 0}, Vec2{800, 600});
+            planner.setVerbose(false);
+            TreePublisher publisher(liveQueue, static_cast<uint8_t>(r));
+            planner.setPublisher(&publisher);
+            planner.run(20000);
+            dropped += publisher.getDropped();
+
+            // what the view should have received, rebuilt from the finished planner
+            for (const auto* node : planner.index().all()) {
+                if (!node->parent) continue;
+                const TreeDelta edge = {static_cast<uint8_t>(r), TreeDelta::EDGE, node->parent->position[0],
+                                        node->parent->position[1], node->position[0], node->position[1]};
+                expected[r].push_back(edge);
+            }
+            const std::vector<Vec2> path = planner.getPath();
+            if (path.empty()) continue;
+            const TreeDelta clear = {static_cast<uint8_t>(r), TreeDelta::PATH_CLEAR, 0, 0, 0, 0};
+            expected[r].push_back(clear);
+            for (size_t i = 1; i < path.size(); ++i) {
+                const TreeDelta edge = {static_cast<uint8_t>(r), TreeDelta::PATH_EDGE, path[i - 1][0], path[i - 1][1], path[i][0], path[i][1]};
+                expected[r].push_back(edge);
+            }
+        }
+        done = true;
+    });
+
+    std::vector<std::vector<TreeDelta> > received(runs);
+    bool ordered = true;
+    for (;;) {
+        const bool finished = done;
+        liveQueue.drain([&](const TreeDelta& delta) {
+            if (delta.source >= runs) {
+                ordered = false;
+                return;
+            }
+            received[delta.source].push_back(delta);
+        });
+        // everything was pushed before done was set, so that drain took the last of it
+        if (finished) break;
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    producer.join();
+
+    size_t edges = 0, missing = 0;
+    for (int r = 0; r < runs; ++r) {
+        edges += received[r].size();
+        // a path edge may arrive between tree edges of the same iteration, so compare each kind in order
+        for (int kind = TreeDelta::EDGE; kind <= TreeDelta::PATH_EDGE; ++kind) {
+            std::vector<const TreeDelta*> want, got;
+            for (const TreeDelta& d : expected[r]) if (d.kind == kind) want.push_back(&d);
+            for (const TreeDelta& d : received[r]) if (d.kind == kind) got.push_back(&d);
+            if (want.size() != got.size()) {
+                missing += want.size() > got.size() ? want.size() - got.size() : got.size() - want.size();
+                continue;
+            }
+            for (size_t i = 0; i < want.size(); ++i) {
+                if (want[i]->x0 != got[i]->x0 || want[i]->y0 != got[i]->y0 || want[i]->x1 != got[i]->x1 || want[i]->y1 != got[i]->y1) {
+                    ordered = false;
+                }
+            }
+        }
+    }
+
+    // the goal lies outside the sampled bounds, so only the flag can end this run early
+    std::atomic<bool> cancel(false);
+    bool found = true;
+    size_t grown = 0;
+    std::thread planning([&] {
+        RRTBase planner("RRT", sf::Color::White, Vec2{10, 10}, Vec2{5000, 5000}, collision, 10.0f);
+        planner.setBounds(Vec2{0, 0}, Vec2{800, 600});
+        planner.setVerbose(false);
+        TreePublisher publisher(liveQueue, 0);
+        planner.setPublisher(&publisher);
+        planner.setCancel(&cancel);
+        found = planner.run(std::numeric_limits<int>::max());
+        grown = planner.index().all().size();
+    });
+    size_t streamed = 0;
+    while (streamed < 100) {
+        liveQueue.drain([&](const TreeDelta&) { ++streamed; });
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    const auto stop = std::chrono::steady_clock::now();
+    cancel = true;
+    planning.join();
+    const double stopMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - stop).count();
+    liveQueue.drain([](const TreeDelta&) {});
+    const bool cancelled = !found && stopMs < 1000.0;
+
+    std::ostringstream detail;
+    detail << edges << " deltas from " << runs << " runs, " << dropped << " dropped, " << missing << " missing, "
+           << (ordered ? "all in order" : "OUT OF ORDER") << ", a cancelled run "
+           << (cancelled ? "stopped" : "DID NOT STOP") << " at " << grown << " nodes";
+    return report("DeltaQueue", dropped == 0 && missing == 0 && ordered && cancelled, detail.str());
+}
+
+} // namespace
+
+int main() {
+    bool ok = true;
+    ok = checkSteering() && ok;
+    ok = checkScenario() && ok;
+    ok = checkTiledWorld() && ok;
+    ok = checkDaemon() && ok;
+    ok = checkMultiGoal() && ok;
+    ok = checkVisibilityGraph() && ok;
+    ok = checkGridPlanner() && ok;
+    ok = checkSamplers() && ok;
+    ok = checkFleet() && ok;
+    ok = checkTreeSnapshot() && ok;
+    ok = checkLiveView() && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,446 @@
+#include "PlannerDaemon.h"
+
+#include <iostream>
+#include <cstring>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/un.h>
+#include "../algorithms/RRT.h"
+#include "../algorithms/RRTStar.h"
+#include "../algorithms/RRTConnect.h"
+
+namespace {
+
+const int POLL_TIMEOUT_MS = 200;
+const uint32_t MAX_ITERATIONS = 1000000;
+const uint32_t DEFAULT_ITERATIONS = 100000;
+const size_t MAX_PENDING_OUTPUT = 64 << 20;     // a client this far behind on its replies is dropped
+
+bool setNonBlocking(int fd) {
+    const int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+uint64_t microsBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+}
+
+template <class PlannerType>
+bool plan(const char* name, const AABBCollision& collision, const ScenarioHeader& world, const PlanRequest& request,
+          PathReply& reply, std::vector<float>& points) {
+    PlannerType planner(name, sf::Color::White, Vec2{request.startX, request.startY}, Vec2{request.goalX, request.goalY},
+                        collision, request.stepSize);
+    planner.setBounds(Vec2{world.worldMinX, world.worldMinY}, Vec2{world.worldMaxX, world.worldMaxY});
+    planner.setVerbose(false);
+
+    const uint32_t budget = request.maxIterations ? request.maxIterations : DEFAULT_ITERATIONS;
+    if (!planner.run(static_cast<int>(budget))) {
+        reply.iterations = budget;
+        return false;
+    }
+
+    reply.iterations = planner.getIterations();
+    reply.distance = planner.getPathDistance();
+    for (const Vec2& point : planner.getPath()) {
+        points.push_back(point[0]);
+        points.push_back(point[1]);
+    }
+    return true;
+}
+
+} // namespace
+
+PlannerDaemon::Connection::~Connection() {
+    ::close(fd);
+}
+
+PlannerDaemon::PlannerDaemon(const std::string& socketPath, int workerCount, int batchSize)
+    : socketPath(socketPath), listenFd(-1), wakeFds{-1, -1}, workerCount(std::max(workerCount, 1)),
+      batchSize(static_cast<size_t>(std::max(batchSize, 1))), stopping(false) {}
+
+PlannerDaemon::~PlannerDaemon() {
+    stop();
+    queueReady.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        unlink(socketPath.c_str());
+    }
+    for (int fd : wakeFds) {
+        if (fd >= 0) ::close(fd);
+    }
+}
+
+bool PlannerDaemon::start() {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "PlannerDaemon: socket path too long: " << socketPath << "\n";
+        return false;
+    }
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cerr << "PlannerDaemon: cannot create socket\n";
+        return false;
+    }
+
+    // a stale socket file from a previous run would make bind fail
+    unlink(socketPath.c_str());
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listenFd, 64) != 0) {
+        std::cerr << "PlannerDaemon: cannot listen on " << socketPath << ": " << std::strerror(errno) << "\n";
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    if (pipe(wakeFds) != 0 || !setNonBlocking(wakeFds[0]) || !setNonBlocking(wakeFds[1])) {
+        std::cerr << "PlannerDaemon: cannot create wake pipe: " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    for (int i = 0; i < workerCount; ++i) {
+        workers.push_back(std::thread(&PlannerDaemon::workerLoop, this));
+    }
+    std::cout << "PlannerDaemon: listening on " << socketPath << " with " << workerCount
+              << " workers, batches of " << batchSize << "\n";
+    return true;
+}
+
+void PlannerDaemon::serve() {
+    std::vector<pollfd> fds;
+    while (!stopping) {
+        fds.clear();
+        pollfd listener = {listenFd, POLLIN, 0};
+        pollfd waker = {wakeFds[0], POLLIN, 0};
+        fds.push_back(listener);
+        fds.push_back(waker);
+        for (auto& connection : connections) {
+            std::lock_guard<std::mutex> lock(connection->writeLock);
+            pollfd client = {connection->fd, static_cast<short>(POLLIN | (connection->output.empty() ? 0 : POLLOUT)), 0};
+            fds.push_back(client);
+        }
+
+        if (poll(fds.data(), fds.size(), POLL_TIMEOUT_MS) <= 0) continue;
+
+        if (fds[1].revents & POLLIN) {
+            char drain[64];
+            while (read(wakeFds[0], drain, sizeof(drain)) > 0) {}
+        }
+        if (fds[0].revents & POLLIN) acceptClients();
+
+        // fds[i + 2] belongs to the connection that was at index i before accepting
+        std::vector<std::shared_ptr<Connection> > alive;
+        for (size_t i = 0; i < connections.size(); ++i) {
+            Connection& connection = *connections[i];
+            const short events = i + 2 < fds.size() ? fds[i + 2].revents : 0;
+            bool keep = connection.open;
+            if (keep && (events & POLLOUT)) {
+                std::lock_guard<std::mutex> lock(connection.writeLock);
+                keep = flushOutput(connection);
+            }
+            if (keep && (events & ~POLLOUT)) keep = readClient(connections[i]);
+            if (!keep) {
+                connection.open = false;
+                continue;
+            }
+            alive.push_back(connections[i]);
+        }
+        connections.swap(alive);
+    }
+
+    // wake the workers so they can drain the queue and exit
+    queueReady.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    for (auto& connection : connections) {
+        connection->open = false;
+    }
+    connections.clear();
+}
+
+void PlannerDaemon::acceptClients() {
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd < 0) return;
+    if (!setNonBlocking(fd)) {
+        ::close(fd);
+        return;
+    }
+    connections.push_back(std::make_shared<Connection>(fd));
+}
+
+bool PlannerDaemon::readClient(const std::shared_ptr<Connection>& connection) {
+    char buffer[4096];
+    ssize_t got = recv(connection->fd, buffer, sizeof(buffer), 0);
+    if (got < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+    if (got <= 0) return false;
+
+    std::vector<char>& input = connection->input;
+    input.insert(input.end(), buffer, buffer + got);
+
+    // handle every complete message, keep the partial tail for the next read
+    size_t offset = 0;
+    while (input.size() - offset >= sizeof(MessageHeader)) {
+        MessageHeader header;
+        std::memcpy(&header, input.data() + offset, sizeof(header));
+        if (header.length > MAX_MESSAGE_LENGTH) {
+            sendError(*connection, 0, ERR_BAD_MESSAGE, "message too long");
+            return false;
+        }
+        if (input.size() - offset - sizeof(header) < header.length) break;
+
+        if (!handleMessage(connection, header.type, input.data() + offset + sizeof(header), header.length)) {
+            return false;
+        }
+        offset += sizeof(header) + header.length;
+    }
+    input.erase(input.begin(), input.begin() + offset);
+    return true;
+}
+
+bool PlannerDaemon::handleMessage(const std::shared_ptr<Connection>& connection, uint32_t type, const char* payload, uint32_t length) {
+    switch (type) {
+    case MSG_LOAD_MAP:
+        loadMap(connection, std::string(payload, length));
+        return true;
+
+    case MSG_PLAN: {
+        PlanRequest request;
+        if (length != sizeof(request)) {
+            sendError(*connection, 0, ERR_BAD_MESSAGE, "PLAN payload has the wrong size");
+            return false;
+        }
+        std::memcpy(&request, payload, sizeof(request));
+        enqueue(connection, request);
+        return true;
+    }
+
+    default:
+        sendError(*connection, 0, ERR_BAD_MESSAGE, "unknown message type");
+        return false;
+    }
+}
+
+void PlannerDaemon::loadMap(const std::shared_ptr<Connection>& connection, const std::string& path) {
+    std::shared_ptr<const WarmMap> warm;
+    {
+        std::lock_guard<std::mutex> lock(mapsLock);
+        auto found = mapsByPath.find(path);
+        if (found != mapsByPath.end()) {
+            warm = found->second;
+        } else {
+            // a cold map is loaded by a worker; requests for it meanwhile wait for the same load
+            std::vector<std::shared_ptr<Connection> >& waiting = loading[path];
+            waiting.push_back(connection);
+            if (waiting.size() > 1) return;
+        }
+    }
+    if (warm) {
+        replyMapLoaded(*connection, *warm);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueLock);
+        coldMaps.push_back(path);
+    }
+    queueReady.notify_one();
+}
+
+void PlannerDaemon::buildMap(const std::string& path) {
+    std::shared_ptr<WarmMap> map = std::make_shared<WarmMap>();
+    bool loaded = !stopping && map->scenario.load(path);
+    if (loaded) {
+        map->path = path;
+        map->collision.reset(new AABBCollision(map->scenario.obstacles(), map->scenario.obstacleCount()));
+    }
+
+    std::vector<std::shared_ptr<Connection> > waiting;
+    {
+        std::lock_guard<std::mutex> lock(mapsLock);
+        waiting.swap(loading[path]);
+        loading.erase(path);
+        if (loaded) {
+            map->id = static_cast<uint32_t>(maps.size());
+            maps.push_back(map);
+            mapsByPath.insert(std::make_pair(path, std::shared_ptr<const WarmMap>(map)));
+        }
+    }
+
+    if (loaded) {
+        std::cout << "PlannerDaemon: map " << map->id << " <- " << path << " ("
+                  << map->scenario.obstacleCount() << " obstacles)\n";
+    }
+    for (auto& connection : waiting) {
+        if (loaded) {
+            replyMapLoaded(*connection, *map);
+        } else {
+            sendError(*connection, 0, ERR_MAP_LOAD_FAILED, "cannot load " + path);
+        }
+    }
+}
+
+void PlannerDaemon::replyMapLoaded(Connection& connection, const WarmMap& map) {
+    MapLoadedReply reply;
+    reply.mapId = map.id;
+    reply.reserved = 0;
+    reply.obstacleCount = map.scenario.obstacleCount();
+    queueReply(connection, MSG_MAP_LOADED, &reply, sizeof(reply));
+}
+
+void PlannerDaemon::enqueue(const std::shared_ptr<Connection>& connection, const PlanRequest& request) {
+    std::shared_ptr<const WarmMap> map;
+    {
+        std::lock_guard<std::mutex> lock(mapsLock);
+        if (request.mapId < maps.size()) map = maps[request.mapId];
+    }
+    if (!map) {
+        sendError(*connection, request.requestId, ERR_UNKNOWN_MAP, "unknown map id");
+        return;
+    }
+    if (request.algorithm > ALG_RRT_CONNECT || !(request.stepSize > 0) || request.maxIterations > MAX_ITERATIONS) {
+        sendError(*connection, request.requestId, ERR_BAD_REQUEST, "bad algorithm, step size or iteration count");
+        return;
+    }
+
+    Job job;
+    job.connection = connection;
+    job.map = map;
+    job.request = request;
+    job.received = Clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(queueLock);
+        std::deque<Job>& queue = pending[request.mapId];
+        if (queue.empty()) readyMaps.push_back(request.mapId);
+        queue.push_back(job);
+    }
+    queueReady.notify_one();
+}
+
+void PlannerDaemon::workerLoop() {
+    std::vector<Job> batch;
+    while (true) {
+        batch.clear();
+        std::string coldMap;
+        {
+            std::unique_lock<std::mutex> lock(queueLock);
+            queueReady.wait(lock, [this] { return stopping || !readyMaps.empty() || !coldMaps.empty(); });
+
+            if (!coldMaps.empty()) {
+                coldMap = coldMaps.front();
+                coldMaps.pop_front();
+            } else if (readyMaps.empty()) {
+                return;
+            } else {
+                // take an even share of the map that has waited longest, at most batchSize queries,
+                // so a burst is split across the workers; if it still has more, it goes to the back
+                const uint32_t mapId = readyMaps.front();
+                readyMaps.pop_front();
+                std::deque<Job>& queue = pending[mapId];
+                const size_t count = static_cast<size_t>(workerCount);
+                const size_t share = std::min(batchSize, (queue.size() + count - 1) / count);
+                while (!queue.empty() && batch.size() < share) {
+                    batch.push_back(queue.front());
+                    queue.pop_front();
+                }
+                if (!queue.empty()) {
+                    readyMaps.push_back(mapId);
+                    queueReady.notify_one();
+                }
+            }
+        }
+
+        if (!coldMap.empty()) {
+            buildMap(coldMap);
+            continue;
+        }
+        for (const Job& job : batch) {
+            runJob(job, batch.size());
+        }
+    }
+}
+
+void PlannerDaemon::runJob(const Job& job, size_t servedWith) {
+    if (!job.connection->open) return;
+
+    const Clock::time_point picked = Clock::now();
+
+    PathReply reply;
+    std::memset(&reply, 0, sizeof(reply));
+    reply.requestId = job.request.requestId;
+    reply.batchSize = static_cast<uint32_t>(servedWith);
+    reply.queueMicros = microsBetween(job.received, picked);
+
+    std::vector<float> points;
+    bool found = false;
+    if (stopping) {
+        reply.status = PATH_CANCELLED;
+    } else {
+        const AABBCollision& collision = *job.map->collision;
+        const ScenarioHeader& world = job.map->scenario.getHeader();
+        switch (job.request.algorithm) {
+        case ALG_RRT:
+            found = plan<RRTBase>("RRT", collision, world, job.request, reply, points);
+            break;
+        case ALG_RRT_STAR:
+            found = plan<RRTStarBase>("RRTStar", collision, world, job.request, reply, points);
+            break;
+        case ALG_RRT_CONNECT:
+            found = plan<RRTConnectBase>("RRTConnect", collision, world, job.request, reply, points);
+            break;
+        }
+        reply.status = found ? PATH_FOUND : PATH_NOT_FOUND;
+    }
+    reply.pointCount = static_cast<uint32_t>(points.size() / 2);
+    reply.planMicros = microsBetween(picked, Clock::now());
+
+    queueReply(*job.connection, MSG_PATH, &reply, sizeof(reply), points.data(), points.size() * sizeof(float));
+}
+
+void PlannerDaemon::queueReply(Connection& connection, uint32_t type, const void* payload, size_t size,
+                               const void* extra, size_t extraSize) {
+    bool pending = false;
+    {
+        std::lock_guard<std::mutex> lock(connection.writeLock);
+        if (!connection.open) return;
+        encodeMessage(connection.output, type, payload, size, extra, extraSize);
+        if (!flushOutput(connection) || connection.output.size() > MAX_PENDING_OUTPUT) {
+            connection.open = false;
+        }
+        pending = !connection.output.empty();
+    }
+    // the I/O thread only polls for POLLOUT on connections it saw with pending output
+    if (pending) wake();
+}
+
+void PlannerDaemon::sendError(Connection& connection, uint32_t requestId, uint32_t code, const std::string& message) {
+    ErrorReply reply = {requestId, code};
+    queueReply(connection, MSG_ERROR, &reply, sizeof(reply), message.data(), message.size());
+}
+
+bool PlannerDaemon::flushOutput(Connection& connection) {
+    size_t written = 0;
+    while (written < connection.output.size()) {
+        ssize_t sent = send(connection.fd, connection.output.data() + written, connection.output.size() - written, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (sent <= 0) return false;
+        written += static_cast<size_t>(sent);
+    }
+    connection.output.erase(0, written);
+    return true;
+}
+
+void PlannerDaemon::wake() {
+    const char byte = 0;
+    // a full pipe already guarantees a wakeup, so the result does not matter
+    ssize_t ignored = write(wakeFds[1], &byte, 1);
+    (void)ignored;
+}
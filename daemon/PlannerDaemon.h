@@ -0,0 +1,114 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include "Protocol.h"
+#include "../algorithms/Scenario.h"
+#include "../algorithms/Policies.h"
+
+////////////////////////////////////////////////////
+//
+// Long-lived planner service (see Protocol.h for the wire format).
+//
+// Maps are loaded once per scenario path and stay warm: the mapped file and
+// its obstacle grid are shared by every query against them. One I/O thread
+// multiplexes the clients with poll() over non-blocking sockets, so a client
+// that stops reading its replies only grows its own output queue. The I/O
+// thread answers LOAD_MAP itself only for a warm map; a cold one is mapped
+// and indexed by a worker. PLAN requests are queued per map and a worker
+// takes an even share of a map's queue, at most batchSize queries, so a
+// burst is spread over the workers while each keeps one map's index hot in
+// cache as it drains its batch.
+//
+////////////////////////////////////////////////////
+class PlannerDaemon {
+public:
+    PlannerDaemon(const std::string& socketPath, int workerCount, int batchSize);
+    ~PlannerDaemon();
+
+    PlannerDaemon(const PlannerDaemon&) = delete;
+    PlannerDaemon& operator=(const PlannerDaemon&) = delete;
+
+    // binds the socket; on failure prints the reason to std::cerr and returns false
+    bool start();
+
+    // serves clients until stop() is called (safe from a signal handler)
+    void serve();
+    void stop() { stopping = true; }
+
+private:
+    struct WarmMap {
+        uint32_t id;
+        std::string path;
+        Scenario scenario;
+        std::unique_ptr<AABBCollision> collision;
+    };
+
+    struct Connection {
+        explicit Connection(int fd) : fd(fd), open(true) {}
+        ~Connection();
+
+        int fd;
+        std::atomic<bool> open;
+        std::mutex writeLock;
+        std::string output;         // framed replies the socket has not taken yet, guarded by writeLock
+        std::vector<char> input;
+    };
+
+    typedef std::chrono::steady_clock Clock;
+
+    struct Job {
+        std::shared_ptr<Connection> connection;
+        std::shared_ptr<const WarmMap> map;
+        PlanRequest request;
+        Clock::time_point received;
+    };
+
+    void acceptClients();
+    bool readClient(const std::shared_ptr<Connection>& connection);
+    bool handleMessage(const std::shared_ptr<Connection>& connection, uint32_t type, const char* payload, uint32_t length);
+    void loadMap(const std::shared_ptr<Connection>& connection, const std::string& path);
+    void buildMap(const std::string& path);     // on a worker
+    void replyMapLoaded(Connection& connection, const WarmMap& map);
+    void enqueue(const std::shared_ptr<Connection>& connection, const PlanRequest& request);
+
+    void workerLoop();
+    void runJob(const Job& job, size_t batchSize);
+
+    // replies never block: they are queued on the connection and written as far as the socket allows;
+    // what is left goes out from the I/O thread when poll reports the socket writable
+    void queueReply(Connection& connection, uint32_t type, const void* payload, size_t size,
+                    const void* extra = nullptr, size_t extraSize = 0);
+    void sendError(Connection& connection, uint32_t requestId, uint32_t code, const std::string& message);
+    static bool flushOutput(Connection& connection);
+    void wake();
+
+    std::string socketPath;
+    int listenFd;
+    int wakeFds[2];             // self-pipe: workers wake poll() when a reply is left pending
+    int workerCount;
+    size_t batchSize;
+    std::atomic<bool> stopping;
+
+    std::vector<std::shared_ptr<Connection> > connections;     // I/O thread only
+
+    std::mutex mapsLock;
+    std::map<std::string, std::shared_ptr<const WarmMap> > mapsByPath;
+    std::vector<std::shared_ptr<const WarmMap> > maps;          // indexed by map id
+    std::map<std::string, std::vector<std::shared_ptr<Connection> > > loading;     // cold path -> LOAD_MAP requests waiting for it
+
+    std::mutex queueLock;
+    std::condition_variable queueReady;
+    std::map<uint32_t, std::deque<Job> > pending;               // per map id
+    std::deque<uint32_t> readyMaps;                             // maps with pending jobs, oldest first
+    std::deque<std::string> coldMaps;                           // paths for a worker to load, taken first
+    std::vector<std::thread> workers;
+};
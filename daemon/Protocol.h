@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+////////////////////////////////////////////////////
+//
+// Wire protocol of the planner daemon, little-endian, over a Unix stream socket.
+//
+// Every message is a MessageHeader followed by `length` payload bytes:
+//
+//   client -> daemon
+//     LOAD_MAP    scenario file path (no terminator)   -> MAP_LOADED or ERROR
+//     PLAN        PlanRequest                          -> PATH or ERROR
+//
+//   daemon -> client
+//     MAP_LOADED  MapLoadedReply
+//     PATH        PathReply, then pointCount (x, y) float pairs
+//     ERROR       ErrorReply, then a message (no terminator)
+//
+// PLAN requests may be pipelined; paths come back in completion order and are
+// matched to their request by requestId. Loading a map that is already warm
+// only returns its id.
+//
+////////////////////////////////////////////////////
+
+const char* const DEFAULT_SOCKET_PATH = "/tmp/path_planning.sock";
+
+// larger messages are a protocol error and close the connection
+const uint32_t MAX_MESSAGE_LENGTH = 4096;
+
+enum MessageType : uint32_t {
+    MSG_LOAD_MAP = 1,
+    MSG_MAP_LOADED = 2,
+    MSG_PLAN = 3,
+    MSG_PATH = 4,
+    MSG_ERROR = 5
+};
+
+enum PlanAlgorithm : uint32_t {
+    ALG_RRT = 0,
+    ALG_RRT_STAR = 1,
+    ALG_RRT_CONNECT = 2
+};
+
+enum PathStatus : uint32_t {
+    PATH_FOUND = 0,
+    PATH_NOT_FOUND = 1,     // iteration budget exhausted
+    PATH_CANCELLED = 2      // daemon shutting down
+};
+
+enum ErrorCode : uint32_t {
+    ERR_BAD_MESSAGE = 1,
+    ERR_UNKNOWN_MAP = 2,
+    ERR_MAP_LOAD_FAILED = 3,
+    ERR_BAD_REQUEST = 4
+};
+
+struct MessageHeader {
+    uint32_t type;
+    uint32_t length;
+};
+
+struct MapLoadedReply {
+    uint32_t mapId;
+    uint32_t reserved;
+    uint64_t obstacleCount;
+};
+
+struct PlanRequest {
+    uint32_t requestId;         // chosen by the client, echoed in the reply
+    uint32_t mapId;
+    uint32_t algorithm;         // PlanAlgorithm
+    uint32_t maxIterations;     // 0 picks the planner default
+    float stepSize;
+    float startX, startY;
+    float goalX, goalY;
+};
+
+struct PathReply {
+    uint32_t requestId;
+    uint32_t status;            // PathStatus
+    uint32_t iterations;        // the whole budget when no path was found
+    uint32_t pointCount;
+    float distance;
+    uint32_t batchSize;         // queries served together with this one
+    uint64_t queueMicros;       // received -> picked up by a worker
+    uint64_t planMicros;
+};
+
+struct ErrorReply {
+    uint32_t requestId;         // 0 when the error is not tied to a PLAN
+    uint32_t code;              // ErrorCode
+};
+
+static_assert(sizeof(MessageHeader) == 8, "MessageHeader is part of the protocol");
+static_assert(sizeof(MapLoadedReply) == 16, "MapLoadedReply is part of the protocol");
+static_assert(sizeof(PlanRequest) == 36, "PlanRequest is part of the protocol");
+static_assert(sizeof(PathReply) == 40, "PathReply is part of the protocol");
+static_assert(sizeof(ErrorReply) == 8, "ErrorReply is part of the protocol");
+
+
+// Blocking helpers shared by the daemon and the client
+
+inline bool sendAll(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t sent = send(fd, bytes, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        bytes += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+inline bool recvAll(int fd, void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t got = recv(fd, bytes, size, 0);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        bytes += got;
+        size -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+// appends the framed message (header, payload, trailing data) to buffer
+inline void encodeMessage(std::string& buffer, uint32_t type, const void* payload, size_t size, const void* extra = nullptr, size_t extraSize = 0) {
+    MessageHeader header = {type, static_cast<uint32_t>(size + extraSize)};
+    buffer.reserve(buffer.size() + sizeof(header) + size + extraSize);
+    buffer.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    buffer.append(static_cast<const char*>(payload), size);
+    if (extraSize) buffer.append(static_cast<const char*>(extra), extraSize);
+}
+
+// header, payload and trailing data go out as one buffer; writers sharing an fd must still serialize
+inline bool sendMessage(int fd, uint32_t type, const void* payload, size_t size, const void* extra = nullptr, size_t extraSize = 0) {
+    std::string buffer;
+    encodeMessage(buffer, type, payload, size, extra, extraSize);
+    return sendAll(fd, buffer.data(), buffer.size());
+}
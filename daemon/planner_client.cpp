@@ -0,0 +1,103 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <unistd.h>
+#include <sys/un.h>
+#include "Protocol.h"
+#include "../algorithms/Scenario.h"
+
+// usage: planner_client <scenario.bin> [algorithm 0..2] [repeat] [socket path]
+//
+// Sends every query stored in the scenario to the daemon, pipelined, and
+// prints the paths and timings as they come back.
+
+bool readMessage(int fd, MessageHeader& header, std::vector<char>& payload) {
+    if (!recvAll(fd, &header, sizeof(header))) return false;
+    payload.resize(header.length);
+    return header.length == 0 || recvAll(fd, payload.data(), header.length);
+}
+
+void printError(const std::vector<char>& payload) {
+    ErrorReply error;
+    std::memcpy(&error, payload.data(), sizeof(error));
+    std::cerr << "error " << error.code << " (request " << error.requestId << "): "
+              << std::string(payload.begin() + sizeof(error), payload.end()) << "\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <scenario.bin> [algorithm 0..2] [repeat] [socket path]\n";
+        return 1;
+    }
+    const uint32_t algorithm = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : static_cast<uint32_t>(ALG_RRT);
+    const int repeat = argc > 3 ? std::max(std::atoi(argv[3]), 1) : 1;
+    const std::string socketPath = argc > 4 ? argv[4] : DEFAULT_SOCKET_PATH;
+
+    // the daemon resolves the path from its own working directory
+    char scenarioPath[PATH_MAX];
+    if (!realpath(argv[1], scenarioPath)) {
+        std::cerr << "cannot find " << argv[1] << "\n";
+        return 1;
+    }
+    Scenario scenario;
+    if (!scenario.load(scenarioPath)) return 1;
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "cannot connect to " << socketPath << "\n";
+        return 1;
+    }
+
+    MessageHeader header;
+    std::vector<char> payload;
+    if (!sendMessage(fd, MSG_LOAD_MAP, scenarioPath, std::strlen(scenarioPath)) || !readMessage(fd, header, payload)) {
+        std::cerr << "daemon closed the connection\n";
+        return 1;
+    }
+    if (header.type != MSG_MAP_LOADED) {
+        printError(payload);
+        return 1;
+    }
+    MapLoadedReply map;
+    std::memcpy(&map, payload.data(), sizeof(map));
+
+    uint32_t sent = 0;
+    for (int r = 0; r < repeat; ++r) {
+        for (size_t q = 0; q < scenario.queryCount(); ++q) {
+            const ScenarioQuery& query = scenario.queries()[q];
+            PlanRequest request = {sent++, map.mapId, algorithm, 0, 10.0f, query.startX, query.startY, query.goalX, query.goalY};
+            if (!sendMessage(fd, MSG_PLAN, &request, sizeof(request))) {
+                std::cerr << "daemon closed the connection\n";
+                return 1;
+            }
+        }
+    }
+
+    int found = 0;
+    for (uint32_t received = 0; received < sent; ++received) {
+        if (!readMessage(fd, header, payload)) {
+            std::cerr << "daemon closed the connection\n";
+            return 1;
+        }
+        if (header.type == MSG_ERROR) {
+            printError(payload);
+            continue;
+        }
+
+        PathReply reply;
+        std::memcpy(&reply, payload.data(), sizeof(reply));
+        found += reply.status == PATH_FOUND;
+        std::cout << "request " << reply.requestId << ": status " << reply.status << ", " << reply.pointCount
+                  << " points, distance " << reply.distance << ", " << reply.iterations << " it, queued "
+                  << reply.queueMicros << " us, planned " << reply.planMicros << " us (batch of " << reply.batchSize << ")\n";
+    }
+    std::cout << found << "/" << sent << " paths found\n";
+
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,30 @@
+#include <iostream>
+#include <cstdlib>
+#include <csignal>
+#include <thread>
+#include "PlannerDaemon.h"
+
+// usage: planner_daemon [socket path] [workers] [batch size]
+
+PlannerDaemon* daemonInstance = nullptr;
+
+void handleSignal(int) {
+    if (daemonInstance) daemonInstance->stop();
+}
+
+int main(int argc, char** argv) {
+    const std::string socketPath = argc > 1 ? argv[1] : DEFAULT_SOCKET_PATH;
+    const int workers = argc > 2 ? std::atoi(argv[2]) : static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    const int batchSize = argc > 3 ? std::atoi(argv[3]) : 8;
+
+    PlannerDaemon daemon(socketPath, workers, batchSize);
+    if (!daemon.start()) return 1;
+
+    daemonInstance = &daemon;
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    daemon.serve();
+    daemonInstance = nullptr;
+    return 0;
+}
@@ -2,12 +2,23 @@
 #include <vector>
 #include <iostream>
 #include <math.h>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 
 //Include here the headers of the algorithms
 #include "algorithms/RRT.h"
 #include "algorithms/RRTConnect.h"
 #include "algorithms/RRTStar.h"
 #include "algorithms/RRTOptimized.h"
+#include "algorithms/VisibilityGraph.h"
+#include "algorithms/GridPlanner.h"
+#include "algorithms/Scenario.h"
+#include "algorithms/TreeSnapshot.h"
+#include "algorithms/DeltaQueue.h"
+
+const std::string scenarioPath = "scenario.bin";
+const std::string treeSnapshotPath = "tree.snap";
 
 sf::RectangleShape header(sf::Vector2f(0, 0));
 
@@ -27,6 +38,19 @@ bool creatingObstacle = false;
 std::vector<sf::RectangleShape> obstacles;
 sf::RectangleShape currentSquare;
 
+// P starts a convex polygon, left clicks add its points and P again closes it (as their hull);
+// Q/E rotate the rectangle under the mouse
+const float rotationStep = 15.0f;
+bool placingPolygon = false;
+std::vector<sf::Vector2f> polygonPoints;
+std::vector<sf::ConvexShape> polygons;
+
+// F cycles the robot footprint; the obstacles are inflated by it once per run
+const int FOOTPRINTS = 3;
+const Footprint footprints[FOOTPRINTS] = {Footprint::point(), Footprint::disc(10.0f), Footprint::rectangle(30.0f, 16.0f)};
+const char* const footprintNames[FOOTPRINTS] = {"point", "disc, radius 10", "rectangle 30x16"};
+int footprintChoice = 0;
+
 sf::Font font;
 sf::RectangleShape button(sf::Vector2f(100, 30));
 sf::Text buttonText;
@@ -39,6 +63,61 @@ RRT* rrtAlgorithm = nullptr;
 RRTStar* rrtSAlgorithm = nullptr;
 RRTConnect* rrtCAlgorithm = nullptr;
 RRTOptimized* rrtOAlgorithm = nullptr;
+VisibilityPlanner* visibilityAlgorithm = nullptr;
+GridPlanner* gridAlgorithm = nullptr;
+
+// the RRT tree of every run is streamed to treeSnapshotPath; R replays the last one
+TreeRecorder treeRecorder;
+TreeSnapshot replay;
+bool replaying = false;
+size_t replayShown = 0;                 // nodes of the snapshot drawn so far
+std::vector<sf::Vertex> replayEdges;    // two vertices per non-root node, in insertion order
+std::vector<sf::Vertex> replayPath;
+sf::Text replayText;
+
+// The planners run on their own thread and stream their trees to the render loop, which
+// shows them growing; once planning is done the planners are drawn as usual
+std::thread planningThread;
+std::atomic<bool> planning(false);
+std::atomic<bool> cancelPlanning(false);   // set by Stop, the planners return at their next iteration
+DeltaQueue liveDeltas;
+const int LIVE_SOURCES = 4;     // RRT, RRTStar, RRTConnect, RRTOptimized
+const sf::Color liveColors[LIVE_SOURCES] = {sf::Color::Yellow, sf::Color::Green, sf::Color(191, 0, 255), sf::Color::Red};
+
+// Lines of one planner's live tree or path. The vertices are mirrored in a vertex buffer that
+// grows geometrically, so a frame uploads only the vertices drained since the previous one and
+// draws the rest from video memory; a growth re-uploads everything, amortized O(1) per vertex.
+struct LiveLayer {
+    LiveLayer() : buffer(sf::Lines, sf::VertexBuffer::Stream), uploaded(0) {}
+
+    void clear() {
+        vertices.clear();
+        uploaded = 0;
+    }
+
+    // called on the render thread, which owns the GL context
+    void upload() {
+        if (uploaded == vertices.size() || !sf::VertexBuffer::isAvailable()) return;
+        if (vertices.size() > buffer.getVertexCount()) {
+            buffer.create(std::max(vertices.size(), std::max<size_t>(2 * buffer.getVertexCount(), 1024)));
+            uploaded = 0;
+        }
+        buffer.update(&vertices[uploaded], vertices.size() - uploaded, static_cast<unsigned>(uploaded));
+        uploaded = vertices.size();
+    }
+
+    void draw(sf::RenderWindow& window) const {
+        if (vertices.empty()) return;
+        if (sf::VertexBuffer::isAvailable()) window.draw(buffer, 0, uploaded);
+        else window.draw(&vertices[0], vertices.size(), sf::Lines);
+    }
+
+    std::vector<sf::Vertex> vertices;
+    sf::VertexBuffer buffer;
+    size_t uploaded;        // vertices already in the buffer
+};
+LiveLayer liveTrees[LIVE_SOURCES];
+LiveLayer livePaths[LIVE_SOURCES];
 
 float calculateAngle(sf::Vector2f p1, sf::Vector2f p2) {
     return atan2(p1.y - p2.y, p1.x - p2.x);
@@ -71,6 +150,86 @@ bool isMouseOverSquare(const sf::RectangleShape& square, const sf::Vector2i& mou
     return square.getGlobalBounds().contains(mousePos.x, mousePos.y);
 }
 
+bool isMouseOverPolygon(const sf::ConvexShape& polygon, const sf::Vector2i& mousePos) {
+    return polygon.getGlobalBounds().contains(mousePos.x, mousePos.y);
+}
+
+// turns the rectangle around its centre
+void rotateObstacle(sf::RectangleShape& square, float degrees) {
+    const sf::Vector2f halfSize = square.getSize() / 2.0f;
+    const sf::Vector2f centre = square.getTransform().transformPoint(halfSize);
+    square.setOrigin(halfSize);
+    square.setPosition(centre);
+    square.rotate(degrees);
+}
+
+void rotateObstacleAt(const sf::Vector2i& mousePos, float degrees) {
+    for (auto& square : obstacles) {
+        if (isMouseOverSquare(square, mousePos)) {
+            rotateObstacle(square, degrees);
+            return;
+        }
+    }
+}
+
+// closes the polygon being placed; fewer than three points not on a line are dropped
+void closePolygon() {
+    std::vector<Vec2> points;
+    for (auto& point : polygonPoints) points.push_back(toVec2(point));
+    const std::vector<Vec2> hull = convexHull(points);
+    polygonPoints.clear();
+    if (hull.size() < 3) return;
+
+    sf::ConvexShape polygon(hull.size());
+    for (size_t i = 0; i < hull.size(); ++i) polygon.setPoint(i, toVector2f(hull[i]));
+    polygon.setFillColor(sf::Color::Blue);
+    polygons.push_back(polygon);
+}
+
+// the rectangles followed by the bounding boxes of the polygons
+std::vector<sf::RectangleShape> withPolygonBounds(const std::vector<sf::RectangleShape>& obstacles,
+                                                  const std::vector<sf::ConvexShape>& polygons) {
+    std::vector<sf::RectangleShape> boxes = obstacles;
+    for (auto& polygon : polygons) {
+        const sf::FloatRect b = polygon.getGlobalBounds();
+        sf::RectangleShape box(sf::Vector2f(b.width, b.height));
+        box.setPosition(b.left, b.top);
+        boxes.push_back(box);
+    }
+    return boxes;
+}
+
+// the grid and visibility planners only know boxes, so they get the inflated bounding boxes
+std::vector<sf::RectangleShape> inflatedBoxes(const std::vector<sf::RectangleShape>& obstacles,
+                                              const std::vector<sf::ConvexShape>& polygons, const Footprint& footprint) {
+    std::vector<ObstacleRect> rects = toObstacleRects(withPolygonBounds(obstacles, polygons));
+    std::vector<std::vector<Vec2> > noPolygons;
+    inflateObstacles(footprint, rects, noPolygons);
+
+    std::vector<sf::RectangleShape> boxes;
+    for (const ObstacleRect& r : rects) {
+        sf::RectangleShape box(sf::Vector2f(r.maxX - r.minX, r.maxY - r.minY));
+        box.setPosition(r.minX, r.minY);
+        boxes.push_back(box);
+    }
+    return boxes;
+}
+
+// outline of the robot at a planned position
+void drawFootprint(sf::RenderWindow& window, sf::Vector2f position) {
+    const Footprint& footprint = footprints[footprintChoice];
+    if (footprint.isPoint()) return;
+
+    const std::vector<Vec2> outline = footprint.outline();
+    sf::ConvexShape shape(outline.size());
+    for (size_t i = 0; i < outline.size(); ++i) shape.setPoint(i, toVector2f(outline[i]));
+    shape.setPosition(position);
+    shape.setFillColor(sf::Color::Transparent);
+    shape.setOutlineColor(sf::Color::White);
+    shape.setOutlineThickness(1);
+    window.draw(shape);
+}
+
 bool isMouseOverHeader(const sf::RectangleShape& header, const sf::Vector2i& mousePos) {
     return header.getGlobalBounds().contains(mousePos.x, mousePos.y);
 }
@@ -87,6 +246,8 @@ void headerDraw(sf::RenderWindow& window) {
 
     window.draw(button);
     window.draw(buttonText);
+
+    if (replaying) window.draw(replayText);
 }
 
 void windowDraw(sf::RenderWindow& window) {
@@ -105,13 +266,25 @@ void windowDraw(sf::RenderWindow& window) {
         window.draw(square);
     }
 
+    for (auto& polygon : polygons) {
+        window.draw(polygon);
+    }
+
+    if (placingPolygon) {
+        std::vector<sf::Vertex> outline;
+        for (auto& point : polygonPoints) outline.push_back(sf::Vertex(point, sf::Color::White));
+        if (!outline.empty()) window.draw(&outline[0], outline.size(), sf::LineStrip);
+    }
+
     if (dotsPlaced[0]) {
+        drawFootprint(window, startPos.getPosition());
         window.draw(startPos);
         window.draw(startLabel);
         window.draw(startLine);
     }
 
     if (dotsPlaced[1]) {
+        drawFootprint(window, goalPos.getPosition());
         window.draw(goalPos);
         window.draw(goalLabel);
         window.draw(goalLine);
@@ -125,23 +298,170 @@ void windowDraw(sf::RenderWindow& window) {
 }
 
 
+////////////////////////////////////////////////////
+//
+// Scenario files: S saves the current map and start/goal, L loads it back.
+// The format only holds boxes, so rotated rectangles and polygons are saved
+// as their bounding boxes
+//
+////////////////////////////////////////////////////
+void saveScenario(const std::string& path) {
+    std::vector<ScenarioQuery> queries;
+    if (dotsPlaced[0] && dotsPlaced[1]) {
+        ScenarioQuery query;
+        query.startX = startPos.getPosition().x;
+        query.startY = startPos.getPosition().y;
+        query.goalX = goalPos.getPosition().x;
+        query.goalY = goalPos.getPosition().y;
+        queries.push_back(query);
+    }
+
+    const std::vector<sf::RectangleShape> boxes = withPolygonBounds(obstacles, polygons);
+    if (Scenario::save(path, 0, 0, 800, 600, toObstacleRects(boxes), queries)) {
+        std::cout << "saved " << boxes.size() << " obstacles to " << path << "\n";
+    }
+}
+
+void loadScenario(const std::string& path, sf::Font& font) {
+    Scenario scenario;
+    if (!scenario.load(path)) return;
+
+    obstacles.clear();
+    polygons.clear();
+    for (size_t i = 0; i < scenario.obstacleCount(); ++i) {
+        const ObstacleRect& rect = scenario.obstacles()[i];
+        sf::RectangleShape square(sf::Vector2f(rect.maxX - rect.minX, rect.maxY - rect.minY));
+        square.setFillColor(sf::Color::Blue);
+        square.setPosition(rect.minX, rect.minY);
+        obstacles.push_back(square);
+    }
+
+    if (scenario.queryCount() > 0) {
+        const ScenarioQuery& query = scenario.queries()[0];
+        sf::Vector2i start(query.startX + startPos.getRadius(), query.startY + startPos.getRadius());
+        sf::Vector2i goal(query.goalX + goalPos.getRadius(), query.goalY + goalPos.getRadius());
+
+        assignPos(startPos, start);
+        assignLabel(startLabel, "Start", start, font);
+        assignPos(goalPos, goal);
+        assignLabel(goalLabel, "goal", goal, font);
+        startLine = sf::VertexArray(sf::Lines, 2);
+        goalLine = sf::VertexArray(sf::Lines, 2);
+        dotsPlaced[0] = dotsPlaced[1] = true;
+    }
+
+    std::cout << "loaded " << obstacles.size() << " obstacles from " << path << "\n";
+}
+
+
+////////////////////////////////////////////////////
+//
+// Tree replay: R loads the last recorded tree, Left/Right or the mouse wheel
+// scrub through its growth, R again leaves
+//
+////////////////////////////////////////////////////
+void updateReplayText() {
+    const int iteration = replayShown > 0 ? replay.iteration(replayShown - 1) : 0;
+    replayText.setString("Replay  it " + std::to_string(iteration) + "  nodes " +
+                         std::to_string(replayShown) + "/" + std::to_string(replay.size()));
+}
+
+bool startReplay(const std::string& path, const sf::Font& font) {
+    if (!replay.load(path)) return false;
+    if (replay.getDimension() < 2) {
+        std::cerr << "Replay: " << path << " has no (x, y) to draw\n";
+        return false;
+    }
+
+    replayEdges.clear();
+    for (size_t i = 0; i < replay.size(); ++i) {
+        const int32_t parent = replay.parent(i);
+        if (parent < 0) continue;
+        replayEdges.push_back(sf::Vertex(sf::Vector2f(replay.position(parent)[0], replay.position(parent)[1]), sf::Color(100,100,100,80)));
+        replayEdges.push_back(sf::Vertex(sf::Vector2f(replay.position(i)[0], replay.position(i)[1]), sf::Color(100,100,100,80)));
+    }
+    replayPath.clear();
+    const std::vector<float>& states = replay.path();
+    for (size_t i = 0; i + replay.getDimension() <= states.size(); i += replay.getDimension()) {
+        replayPath.push_back(sf::Vertex(sf::Vector2f(states[i], states[i + 1]), sf::Color::Yellow));
+    }
+
+    replayText.setFont(font);
+    replayText.setCharacterSize(14);
+    replayText.setFillColor(sf::Color::White);
+    replayText.setPosition(120, 12);
+    replayShown = 0;
+    replaying = true;
+    updateReplayText();
+    std::cout << "replaying " << replay.size() << " nodes from " << path << "\n";
+    return true;
+}
+
+void scrubReplay(int steps) {
+    const long stride = std::max<long>(1, static_cast<long>(replay.size()) / 200);
+    const long shown = static_cast<long>(replayShown) + steps * stride;
+    replayShown = static_cast<size_t>(std::min(std::max(shown, 0L), static_cast<long>(replay.size())));
+    updateReplayText();
+}
+
+void drawReplay(sf::RenderWindow& window) {
+    // only the root has no edge and it is recorded first, so node i owns vertices [2 (i - 1), 2 i)
+    const size_t edges = replayShown > 1 ? replayShown - 1 : 0;
+    if (edges > 0) window.draw(&replayEdges[0], std::min(2 * edges, replayEdges.size()), sf::Lines);
+    if (replayShown == replay.size() && replayPath.size() > 1) {
+        window.draw(&replayPath[0], replayPath.size(), sf::LineStrip);
+    }
+}
+
+
 ////////////////////////////////////////////////////
 //
 // Add the algorithm.run() function here
 //
 ////////////////////////////////////////////////////
-void runAlgorithms(sf::Vector2f startPos, sf::Vector2f goalPos, const std::vector<sf::RectangleShape>& obstacles) {
-    rrtAlgorithm = new RRT(startPos, goalPos, obstacles, 20);
+void runAlgorithms(sf::Vector2f startPos, sf::Vector2f goalPos, const std::vector<sf::RectangleShape>& obstacles,
+                   const std::vector<sf::ConvexShape>& polygons, const Footprint& footprint) {
+    // inflated once, shared by the sampling planners
+    const AABBCollision collision(obstacles, polygons, footprint);
+    TreePublisher rrtPublisher(liveDeltas, 0), rrtSPublisher(liveDeltas, 1), rrtCPublisher(liveDeltas, 2), rrtOPublisher(liveDeltas, 3);
+
+    rrtAlgorithm = new RRT(startPos, goalPos, collision, 20);
+    if (treeRecorder.open(treeSnapshotPath, 2)) rrtAlgorithm->setRecorder(&treeRecorder);
+    rrtAlgorithm->setPublisher(&rrtPublisher);
+    rrtAlgorithm->setCancel(&cancelPlanning);
     rrtAlgorithm->run();
-
-    rrtSAlgorithm = new RRTStar(startPos, goalPos, obstacles);
+    rrtAlgorithm->setRecorder(nullptr);
+    rrtAlgorithm->setPublisher(nullptr);
+    treeRecorder.close();
+    if (cancelPlanning) return;
+
+    rrtSAlgorithm = new RRTStar(startPos, goalPos, collision);
+    rrtSAlgorithm->setPublisher(&rrtSPublisher);
+    rrtSAlgorithm->setCancel(&cancelPlanning);
     rrtSAlgorithm->run();
+    rrtSAlgorithm->setPublisher(nullptr);
+    if (cancelPlanning) return;
 
-    rrtCAlgorithm = new RRTConnect(startPos, goalPos, obstacles);    
+    rrtCAlgorithm = new RRTConnect(startPos, goalPos, collision);
+    rrtCAlgorithm->setPublisher(&rrtCPublisher);
+    rrtCAlgorithm->setCancel(&cancelPlanning);
     rrtCAlgorithm->run();
+    rrtCAlgorithm->setPublisher(nullptr);
+    if (cancelPlanning) return;
 
-    rrtOAlgorithm = new RRTOptimized(startPos, goalPos, obstacles, 20);
+    rrtOAlgorithm = new RRTOptimized(startPos, goalPos, collision, 20);
+    rrtOAlgorithm->setPublisher(&rrtOPublisher);
+    rrtOAlgorithm->setCancel(&cancelPlanning);
     rrtOAlgorithm->run();
+    rrtOAlgorithm->setPublisher(nullptr);
+    if (cancelPlanning) return;
+
+    const std::vector<sf::RectangleShape> boxes = inflatedBoxes(obstacles, polygons, footprint);
+    visibilityAlgorithm = new VisibilityPlanner(startPos, goalPos, boxes);
+    visibilityAlgorithm->run();
+
+    gridAlgorithm = new GridPlanner(startPos, goalPos, boxes);
+    gridAlgorithm->run();
 }
 
 
@@ -155,13 +475,76 @@ void destroyAlgorithms() {
     if (rrtSAlgorithm) delete rrtSAlgorithm;
     if (rrtCAlgorithm) delete rrtCAlgorithm;
     if (rrtOAlgorithm) delete rrtOAlgorithm;
+    if (visibilityAlgorithm) delete visibilityAlgorithm;
+    if (gridAlgorithm) delete gridAlgorithm;
 
     rrtAlgorithm = nullptr;
     rrtSAlgorithm = nullptr;
     rrtCAlgorithm = nullptr;
     rrtOAlgorithm = nullptr;
+    visibilityAlgorithm = nullptr;
+    gridAlgorithm = nullptr;
+}
+
+////////////////////////////////////////////////////
+//
+// Planning thread and live view. Play starts runAlgorithms on the planning
+// thread with a copy of the obstacles and polygons; the render loop drains the new edges
+// every frame, so its work only depends on what arrived since the last one
+//
+////////////////////////////////////////////////////
+void startPlanning(sf::Vector2f startPos, sf::Vector2f goalPos, const std::vector<sf::RectangleShape>& obstacles,
+                   const std::vector<sf::ConvexShape>& polygons, const Footprint& footprint) {
+    if (planning) return;
+    if (planningThread.joinable()) planningThread.join();
+    destroyAlgorithms();
+
+    liveDeltas.drain([](const TreeDelta&) {});
+    for (int i = 0; i < LIVE_SOURCES; ++i) {
+        liveTrees[i].clear();
+        livePaths[i].clear();
+    }
+
+    cancelPlanning = false;
+    planning = true;
+    planningThread = std::thread([startPos, goalPos, obstacles, polygons, footprint]() {
+        runAlgorithms(startPos, goalPos, obstacles, polygons, footprint);
+        planning = false;
+    });
+}
+
+// cancels a running plan and waits for the planning thread to return
+void stopPlanning() {
+    cancelPlanning = true;
+    if (planningThread.joinable()) planningThread.join();
+    destroyAlgorithms();
+}
+
+void drainLiveDeltas() {
+    liveDeltas.drain([](const TreeDelta& delta) {
+        if (delta.source >= LIVE_SOURCES) return;
+        if (delta.kind == TreeDelta::PATH_CLEAR) {
+            livePaths[delta.source].clear();
+            return;
+        }
+        const bool isPath = delta.kind == TreeDelta::PATH_EDGE;
+        const sf::Color color = isPath ? liveColors[delta.source] : sf::Color(100,100,100,80);
+        std::vector<sf::Vertex>& target = isPath ? livePaths[delta.source].vertices : liveTrees[delta.source].vertices;
+        target.push_back(sf::Vertex(sf::Vector2f(delta.x0, delta.y0), color));
+        target.push_back(sf::Vertex(sf::Vector2f(delta.x1, delta.y1), color));
+    });
+    for (int i = 0; i < LIVE_SOURCES; ++i) {
+        liveTrees[i].upload();
+        livePaths[i].upload();
+    }
+}
+
+void drawLive(sf::RenderWindow& window) {
+    for (int i = 0; i < LIVE_SOURCES; ++i) liveTrees[i].draw(window);
+    for (int i = 0; i < LIVE_SOURCES; ++i) livePaths[i].draw(window);
 }
 
+
 ////////////////////////////////////////////////////
 //
 // To print the algorithms, call the drawTree and drawPath 
@@ -185,6 +568,14 @@ void printAlgorithms(sf::RenderWindow &window) {
     if (rrtOAlgorithm) {
         rrtOAlgorithm->drawPath(window);
     }
+
+    if (visibilityAlgorithm) {
+        visibilityAlgorithm->drawPath(window);
+    }
+
+    if (gridAlgorithm) {
+        gridAlgorithm->drawPath(window);
+    }
 }
 
 int main() {
@@ -222,12 +613,47 @@ int main() {
     while (window.isOpen()) {
         // Create an event object to handle events
         sf::Event event;
+
+        // The planning thread finished on its own: back to editing
+        if (gameStarted && !planning) {
+            button.setFillColor(sf::Color(0,120,200));
+            buttonText.setString("Play");
+            gameStarted = false;
+        }
+
         // Process events
         while (window.pollEvent(event)) {
             // Close window: exit
             if (event.type == sf::Event::Closed)
                 window.close();
 
+            // Handle scenario save/load
+            if (event.type == sf::Event::KeyPressed && !gameStarted && !creatingObstacle) {
+                if (event.key.code == sf::Keyboard::S) saveScenario(scenarioPath);
+                if (event.key.code == sf::Keyboard::L) loadScenario(scenarioPath, font);
+                if (event.key.code == sf::Keyboard::R) {
+                    if (replaying) replaying = false;
+                    else startReplay(treeSnapshotPath, font);
+                }
+                if (replaying && event.key.code == sf::Keyboard::Right) scrubReplay(1);
+                if (replaying && event.key.code == sf::Keyboard::Left) scrubReplay(-1);
+
+                sf::Vector2i mousePosition = sf::Mouse::getPosition(window);
+                if (event.key.code == sf::Keyboard::Q) rotateObstacleAt(mousePosition, -rotationStep);
+                if (event.key.code == sf::Keyboard::E) rotateObstacleAt(mousePosition, rotationStep);
+                if (event.key.code == sf::Keyboard::F) {
+                    footprintChoice = (footprintChoice + 1) % FOOTPRINTS;
+                    std::cout << "robot footprint: " << footprintNames[footprintChoice] << "\n";
+                }
+                if (event.key.code == sf::Keyboard::P) {
+                    if (placingPolygon) closePolygon();
+                    placingPolygon = !placingPolygon;
+                }
+            }
+            if (event.type == sf::Event::MouseWheelScrolled && replaying) {
+                scrubReplay(event.mouseWheelScroll.delta > 0 ? 5 : -5);
+            }
+
             // Handle mouse click event
             if (event.type == sf::Event::MouseButtonPressed) {
                 sf::Vector2i mousePosition = sf::Mouse::getPosition(window);
@@ -240,17 +666,13 @@ int main() {
                             buttonText.setString("Stop");
                             gameStarted = true;
 
-                            button.setFillColor(sf::Color(0,120,200)); // Change color on click
-                            buttonText.setString("Play");
-                            gameStarted = false;
-
-                            runAlgorithms(startPos.getPosition(), goalPos.getPosition(), obstacles);
+                            startPlanning(startPos.getPosition(), goalPos.getPosition(), obstacles, polygons, footprints[footprintChoice]);
                         } else if (gameStarted) {
                             button.setFillColor(sf::Color(0,120,200));
                             buttonText.setString("Play");
                             gameStarted = false;
 
-                            destroyAlgorithms();
+                            stopPlanning();
                         }
                     }
 
@@ -258,6 +680,12 @@ int main() {
                     if (creatingObstacle) break;
                     if (gameStarted) break;
 
+                    // Handle polygon point placement
+                    if (placingPolygon) {
+                        polygonPoints.push_back(sf::Vector2f(mousePosition.x, mousePosition.y));
+                        break;
+                    }
+
                     // Handle obstacle removal clicks
                     bool obstacleClicked = false;
                     for (auto it = obstacles.begin(); it != obstacles.end(); ++it) {
@@ -268,6 +696,14 @@ int main() {
                         }
                     }
                     if (obstacleClicked) break;
+                    for (auto it = polygons.begin(); it != polygons.end(); ++it) {
+                        if (isMouseOverPolygon(*it, mousePosition)) {
+                            obstacleClicked = true;
+                            polygons.erase(it);
+                            break;
+                        }
+                    }
+                    if (obstacleClicked) break;
 
                     // Handle start dot placement
                     if (!drawingDots[0]) {
@@ -346,13 +782,20 @@ int main() {
 
         windowDraw(window);        
 
-        printAlgorithms(window);
+        drainLiveDeltas();
+        if (planning) {
+            drawLive(window);
+        } else {
+            printAlgorithms(window);
+        }
+
+        if (replaying) drawReplay(window);
 
         // Update the window
         window.display();
     }
 
-    if (rrtAlgorithm) delete rrtAlgorithm;
+    stopPlanning();
 
     return 0;
 }